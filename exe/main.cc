@@ -1,9 +1,12 @@
 #include <puppet/compiler/settings.hpp>
 #include <puppet/compiler/node.hpp>
 #include <puppet/compiler/exceptions.hpp>
+#include <puppet/compiler/scheduler.hpp>
+#include <puppet/compiler/server.hpp>
 #include <puppet/facts/yaml.hpp>
 #include <boost/filesystem.hpp>
 #include <fstream>
+#include <algorithm>
 
 using namespace std;
 using namespace puppet;
@@ -13,6 +16,154 @@ using namespace puppet::runtime;
 using namespace puppet::compiler;
 namespace fs = boost::filesystem;
 
+static void write_catalog(
+    logging::logger& logger,
+    compiler::catalog const& catalog,
+    string const& path,
+    catalog_format format,
+    bool compact,
+    catalog_summary const* previous = nullptr)
+{
+    // Write to a temporary file in the same directory and rename it over the target once complete
+    auto temporary = path + ".tmp";
+    ofstream output(temporary, format == catalog_format::cbor ? ios::out | ios::binary : ios::out);
+    if (!output) {
+        // Log rather than throw so that the remaining nodes are still compiled when using --nodes-from
+        LOG(error, "cannot open '%1%' for writing.", temporary);
+        return;
+    }
+    catalog.write(output, format, !compact, previous);
+    output.close();
+
+    boost::system::error_code ec;
+    if (!output) {
+        LOG(error, "cannot write to '%1%'.", temporary);
+    } else {
+        fs::rename(temporary, path, ec);
+        if (!ec) {
+            return;
+        }
+        LOG(error, "cannot rename '%1%' to '%2%': %3%.", temporary, path, ec.message());
+    }
+    fs::remove(temporary, ec);
+}
+
+static void compile_node(
+    logging::logger& logger,
+    shared_ptr<compiler::environment> const& environment,
+    string const& name,
+    shared_ptr<facts::provider> facts,
+    string const& output_file,
+    string const& graph_file,
+    string const& previous_file,
+    catalog_format format,
+    bool compact)
+{
+    // Construct a node
+    node node{logger, name, environment, rvalue_cast(facts)};
+
+    // Load the previous catalog before writing anything as the output may replace it
+    catalog_summary previous;
+    if (!previous_file.empty() && !previous.load(previous_file)) {
+        LOG(warning, "cannot read previous catalog '%1%': all resources will be written as added.", previous_file);
+        previous = catalog_summary{};
+    }
+
+    try {
+        LOG(notice, "compiling for node '%1%' with environment '%2%'.", node.name(), environment->name());
+
+        // Compile the node
+        auto catalog = node.compile();
+
+        // Write the graph file if given one
+        if (!graph_file.empty()) {
+            auto path = (fs::current_path() / graph_file).string();
+            ofstream file(path);
+            if (!file) {
+                LOG(error, "cannot open '%1%' for writing.", path);
+            } else {
+                LOG(notice, "writing dependency graph to '%1%'.", path);
+                catalog.write_graph(file);
+            }
+        }
+
+        // Detect dependency cycles
+        catalog.detect_cycles();
+
+        // Always write the entire catalog so that the next compilation has a full catalog to find changes against
+        LOG(notice, "writing catalog to '%1%'.", output_file);
+        write_catalog(logger, catalog, output_file, format, compact);
+
+        // Write the changes since the previous catalog next to the catalog (e.g. 'catalog.json' -> 'catalog.changes.json')
+        if (!previous_file.empty()) {
+            fs::path changes_file{output_file};
+            auto extension = changes_file.extension();
+            changes_file.replace_extension(".changes");
+            changes_file += extension;
+
+            LOG(notice, "writing catalog changes to '%1%'.", changes_file.string());
+            write_catalog(logger, catalog, changes_file.string(), format, compact, &previous);
+        }
+    } catch (compilation_exception const& ex) {
+        LOG(error, ex.line(), ex.column(), ex.text(), ex.path(), "node '%1%': %2%", node.name(), ex.what());
+    } catch (resource_cycle_exception const& ex) {
+        LOG(error, ex.what());
+    }
+}
+
+static void compile_nodes(logging::logger& logger, compiler::settings const& settings, shared_ptr<compiler::environment> const& environment)
+{
+    // Gather the facts files in a deterministic order
+    vector<fs::path> files;
+    fs::directory_iterator it{settings.nodes_directory()};
+    fs::directory_iterator end{};
+    for (; it != end; ++it) {
+        if (fs::is_regular_file(it->status()) && it->path().extension() == ".yaml") {
+            files.emplace_back(it->path());
+        }
+    }
+    sort(files.begin(), files.end());
+
+    if (files.empty()) {
+        LOG(warning, "no YAML facts files were found in '%1%'.", settings.nodes_directory());
+        return;
+    }
+
+    auto output_directory = settings.output_directory().empty() ? fs::current_path() : fs::path{settings.output_directory()};
+    auto extension = settings.output_format() == catalog_format::cbor ? ".cbor" : ".json";
+
+    // Previous catalogs are looked for by node name in the previous directory, if given
+    auto previous_file = [&](string const& name) {
+        if (settings.previous_path().empty()) {
+            return string{};
+        }
+        return (fs::path{settings.previous_path()} / (name + extension)).string();
+    };
+
+    // Compile each node concurrently against the same environment so that parsed manifests and definitions are reused
+    // Each task has its own node, catalog, and evaluation context; only the environment and logger are shared
+    compiler::scheduler scheduler{ min(settings.jobs(), files.size()) };
+    LOG(debug, "compiling %1% nodes using %2% threads.", files.size(), scheduler.threads());
+
+    for (auto const& file : files) {
+        scheduler.queue([&, file]() {
+            auto name = file.stem().string();
+
+            shared_ptr<facts::provider> facts;
+            try {
+                facts = make_shared<facts::yaml>(file.string());
+            } catch (yaml_parse_exception const& ex) {
+                LOG(error, ex.line(), ex.column(), ex.text(), ex.path(), "node '%1%': %2%", name, ex.what());
+                return;
+            }
+            compile_node(logger, environment, name, rvalue_cast(facts), (output_directory / (name + extension)).string(), {}, previous_file(name), settings.output_format(), settings.compact_output());
+        });
+    }
+    scheduler.wait();
+
+    LOG(notice, "compiled catalogs for %1% %2% using environment '%3%'.", files.size(), (files.size() != 1 ? "nodes" : "node"), environment->name());
+}
+
 int main(int argc, char const* argv[])
 {
     console_logger logger;
@@ -42,48 +193,32 @@ int main(int argc, char const* argv[])
         // Construct an environment and load the modules
         auto environment = make_shared<compiler::environment>(logger, settings, settings.environment(), settings.environment_directory());
 
-        // Construct a node
-        node node{logger, settings.node_name(), rvalue_cast(environment), settings.facts()};
-
-        // Open the output file for writing
-        auto output_file = (fs::current_path() / settings.output_file()).string();
-        ofstream output(output_file);
-        if (!output) {
-            throw settings_exception((boost::format("cannot open '%1%' for writing.") % output_file).str());
+        // When compiling more than one node, parse every module's manifests up front using all threads
+        if (!settings.socket_path().empty() || !settings.nodes_directory().empty()) {
+            environment->preload(logger);
         }
 
-        try {
-            LOG(notice, "compiling for node '%1%' with environment '%2%'.", settings.node_name(), settings.environment());
-
-            // Compile the node
-            auto catalog = node.compile();
-
-            // Write the graph file if given one
-            if (!settings.graph_file().empty()) {
-                auto graph_file = (fs::current_path() / settings.graph_file()).string();
-                ofstream file(graph_file);
-                if (!file) {
-                    LOG(error, "cannot open '%1%' for writing.", graph_file);
-                } else {
-                    LOG(notice, "writing dependency graph to '%1%'.", graph_file);
-                    catalog.write_graph(file);
-                }
-            }
-
-            // Detect dependency cycles
-            catalog.detect_cycles();
-
-            // Write the catalog
-            LOG(notice, "writing catalog to '%1%'.", output_file);
-            catalog.write(output);
-
-        } catch (compilation_exception const& ex) {
-            LOG(error, ex.line(), ex.column(), ex.text(), ex.path(), "node '%1%': %2%", node.name(), ex.what());
-        } catch (resource_cycle_exception const& ex) {
-            LOG(error, ex.what());
+        if (!settings.socket_path().empty()) {
+            compiler::server server{logger, environment, settings.socket_path(), settings.jobs(), settings.compact_output()};
+            server.run();
+        } else if (settings.nodes_directory().empty()) {
+            compile_node(
+                logger,
+                environment,
+                settings.node_name(),
+                settings.facts(),
+                (fs::current_path() / settings.output_file()).string(),
+                settings.graph_file(),
+                settings.previous_path(),
+                settings.output_format(),
+                settings.compact_output());
+        } else {
+            compile_nodes(logger, settings, environment);
         }
     } catch (yaml_parse_exception const& ex) {
         LOG(error, ex.line(), ex.column(), ex.text(), ex.path(), ex.what());
+    } catch (server_exception const& ex) {
+        LOG(error, ex.what());
     } catch (settings_exception const& ex) {
         LOG(error, ex.what());
         LOG(notice, "use 'puppetcpp --help' for help.");
@@ -0,0 +1,150 @@
+/**
+ * @file
+ * Declares the compilation arena.
+ */
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace puppet { namespace compiler {
+
+    /**
+     * Represents a monotonic memory arena.
+     * Memory is allocated from large blocks and is only released, all at once, when the arena is destroyed.
+     * This suits objects that live until a catalog is discarded, avoiding a heap allocation and deallocation for each one.
+     * The arena is not thread safe.
+     */
+    struct arena
+    {
+        /**
+         * Constructs an arena.
+         * @param block_size The size of the first block to allocate from; later blocks double in size.
+         */
+        explicit arena(size_t block_size = 64 * 1024);
+
+        /**
+         * Allocates memory from the arena.
+         * @param size The number of bytes to allocate.
+         * @param alignment The alignment of the memory.
+         * @return Returns the allocated memory.
+         */
+        void* allocate(size_t size, size_t alignment);
+
+        /**
+         * Gets the number of bytes allocated from the arena.
+         * @return Returns the number of bytes allocated from the arena.
+         */
+        size_t allocated() const;
+
+        /**
+         * Creates a shared object whose object and control block are allocated from the arena.
+         * The arena must outlive every shared pointer to the object.
+         * @tparam T The type of object to create.
+         * @tparam Args The types of the constructor arguments.
+         * @param args The constructor arguments.
+         * @return Returns the shared object.
+         */
+        template <typename T, typename... Args>
+        std::shared_ptr<T> make_shared(Args&&... args);
+
+     private:
+        arena(arena&) = delete;
+        arena& operator=(arena&) = delete;
+
+        std::vector<std::unique_ptr<char[]>> _blocks;
+        char* _current;
+        size_t _remaining;
+        size_t _block_size;
+        size_t _allocated;
+    };
+
+    /**
+     * Represents a standard allocator that allocates from an arena.
+     * Deallocation is a no-op; memory is released when the arena is destroyed.
+     * @tparam T The type being allocated.
+     */
+    template <typename T>
+    struct arena_allocator
+    {
+        /**
+         * The type being allocated.
+         */
+        using value_type = T;
+
+        /**
+         * Constructs an arena allocator.
+         * @param arena The arena to allocate from.
+         */
+        explicit arena_allocator(compiler::arena& arena) :
+            _arena(&arena)
+        {
+        }
+
+        /**
+         * Constructs an arena allocator from an allocator of another type.
+         * @tparam U The type allocated by the other allocator.
+         * @param other The other allocator.
+         */
+        template <typename U>
+        arena_allocator(arena_allocator<U> const& other) :
+            _arena(other._arena)
+        {
+        }
+
+        /**
+         * Allocates memory for the given number of objects.
+         * @param count The number of objects to allocate memory for.
+         * @return Returns the allocated memory.
+         */
+        T* allocate(size_t count)
+        {
+            return static_cast<T*>(_arena->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        /**
+         * Deallocates memory; this is a no-op as memory is released with the arena.
+         */
+        void deallocate(T*, size_t)
+        {
+        }
+
+        /**
+         * Equality operator for arena allocator.
+         * @tparam U The type allocated by the other allocator.
+         * @param other The other allocator.
+         * @return Returns true if both allocators use the same arena or false if not.
+         */
+        template <typename U>
+        bool operator==(arena_allocator<U> const& other) const
+        {
+            return _arena == other._arena;
+        }
+
+        /**
+         * Inequality operator for arena allocator.
+         * @tparam U The type allocated by the other allocator.
+         * @param other The other allocator.
+         * @return Returns true if the allocators use different arenas or false if not.
+         */
+        template <typename U>
+        bool operator!=(arena_allocator<U> const& other) const
+        {
+            return _arena != other._arena;
+        }
+
+     private:
+        template <typename U> friend struct arena_allocator;
+
+        compiler::arena* _arena;
+    };
+
+    template <typename T, typename... Args>
+    std::shared_ptr<T> arena::make_shared(Args&&... args)
+    {
+        return std::allocate_shared<T>(arena_allocator<T>(*this), std::forward<Args>(args)...);
+    }
+
+}}  // namespace puppet::compiler
@@ -0,0 +1,40 @@
+/**
+ * @file
+ * Declares the binary serialization of syntax trees.
+ */
+#pragma once
+
+#include "ast.hpp"
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace puppet { namespace compiler { namespace ast {
+
+    /**
+     * Serializes a syntax tree into a compact binary representation.
+     * The representation is only intended to be read back with the same format version on the same platform.
+     * @param out The output stream to write to.
+     * @param tree The syntax tree to serialize.
+     */
+    void serialize(std::ostream& out, syntax_tree const& tree);
+
+    /**
+     * The version of the serialized format.
+     * This must be incremented whenever the AST structures or their serialization change; data serialized with a
+     * different version must not be deserialized.
+     */
+    constexpr uint32_t format_version = 1;
+
+    /**
+     * Deserializes a syntax tree from its binary representation.
+     * @param data The serialized data.
+     * @param size The size of the serialized data.
+     * @param path The path of the file the syntax tree was parsed from.
+     * @param module The module containing the file or nullptr if the file is not in a module.
+     * @return Returns the syntax tree or nullptr if the data is not a valid serialized syntax tree.
+     */
+    std::shared_ptr<syntax_tree> deserialize(char const* data, size_t size, std::string path, compiler::module const* module = nullptr);
+
+}}}  // namespace puppet::compiler::ast
@@ -0,0 +1,63 @@
+/**
+ * @file
+ * Declares the on-disk syntax tree cache.
+ */
+#pragma once
+
+#include "ast/ast.hpp"
+#include "../logging/logger.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace puppet { namespace compiler {
+
+    /**
+     * Represents an on-disk cache of serialized syntax trees.
+     * Cached trees are keyed by the file's path, a hash of the file's contents, the compiler version, and the AST serialization format version.
+     * A cached tree is only used if the file's contents are unchanged since the tree was stored.
+     */
+    struct ast_cache
+    {
+        /**
+         * Constructs an AST cache.
+         * @param directory The directory to store cached syntax trees in.
+         */
+        explicit ast_cache(std::string directory);
+
+        /**
+         * Gets the directory used by the cache.
+         * @return Returns the directory used by the cache.
+         */
+        std::string const& directory() const;
+
+        /**
+         * Parses a file, using the cached syntax tree if the file has not changed.
+         * If the file is parsed, the resulting syntax tree is stored in the cache.
+         * Throws parse_exception if the file cannot be parsed.
+         * @param logger The logger to use to log messages.
+         * @param path The path of the file to parse.
+         * @param module The module containing the file or nullptr if the file is not in a module.
+         * @return Returns the syntax tree for the file.
+         */
+        std::shared_ptr<ast::syntax_tree> parse(logging::logger& logger, std::string const& path, compiler::module const* module = nullptr);
+
+        /**
+         * Gets the number of files that were loaded from the cache.
+         * @return Returns the number of cache hits.
+         */
+        size_t hits() const;
+
+        /**
+         * Gets the number of files that were parsed because they were not in the cache.
+         * @return Returns the number of cache misses.
+         */
+        size_t misses() const;
+
+     private:
+        std::string _directory;
+        std::atomic<size_t> _hits;
+        std::atomic<size_t> _misses;
+    };
+
+}}  // puppet::compiler
@@ -4,17 +4,35 @@
  */
 #pragma once
 
+#include "arena.hpp"
+#include "catalog_summary.hpp"
 #include "resource.hpp"
 #include <boost/graph/adjacency_list.hpp>
 #include <string>
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
 #include <deque>
 
 namespace puppet { namespace compiler {
 
+    /**
+     * Represents the formats a catalog can be written in.
+     */
+    enum class catalog_format
+    {
+        /**
+         * JSON.
+         */
+        json,
+        /**
+         * CBOR (RFC 7049), a compact binary encoding of the same structure as the JSON format.
+         */
+        cbor
+    };
+
     /**
      * Represents the possible resource relationship types.
      */
@@ -75,15 +93,23 @@ namespace puppet { namespace compiler {
         catalog(std::string node, std::string environment);
 
         /**
-         * Default move constructor for catalog.
+         * Move constructor for catalog.
+         * @param other The catalog to move from.
          */
-        catalog(catalog&&) = default;
+        catalog(catalog&& other);
 
         /**
-         * Default move assignment operator for catalog.
+         * Move assignment operator for catalog.
+         * @param other The catalog to move from.
          * @return Returns this catalog.
          */
-        catalog& operator=(catalog&&) = default;
+        catalog& operator=(catalog&& other);
+
+        /**
+         * Gets the arena for allocations that live as long as the catalog (e.g. resource attributes).
+         * @return Returns the catalog's arena.
+         */
+        compiler::arena& arena();
 
         /**
          * Gets the name of the node this catalog was compiled for.
@@ -133,6 +159,17 @@ namespace puppet { namespace compiler {
          */
         size_t size() const;
 
+        /**
+         * Gets the digest of the catalog's content.
+         * The digest covers the node and environment names, the realized resources (see resource::hash), and the relationships.
+         * Declared classes are resources and inherited tags follow the containment relationships, so every written part of the catalog
+         * except its version is covered; catalogs with the same digest can be treated as duplicates.
+         * It is updated as the catalog is built and does not depend on the order resources, attributes or relationships were added in.
+         * Unlike the catalog's version, the digest is the same for every compilation of the same code and facts.
+         * @return Returns the digest of the catalog's content.
+         */
+        runtime::digest const& hash() const;
+
         /**
          * Enumerates the resources in the catalog.
          * @param callback The callback to call for each resource.
@@ -149,6 +186,18 @@ namespace puppet { namespace compiler {
          */
         void each(std::function<bool(resource const&)> const& callback, std::string const& type = std::string(), size_t offset = 0) const;
 
+        /**
+         * Enumerates the resources of the given type with an attribute equal to, or an array attribute containing, the given string.
+         * Strings are compared case-insensitively.
+         * The index for the attribute is built on first use and is kept up to date as attributes are set.
+         * A resource may be enumerated more than once or after its attribute has changed, so callers should check each resource.
+         * @param callback The callback to call for each resource.
+         * @param type The type of resources to enumerate.
+         * @param attribute The name of the attribute to match.
+         * @param value The string to match.
+         */
+        void each_matching(std::function<bool(resource&)> const& callback, std::string const& type, std::string const& attribute, std::string const& value);
+
         /**
          * Enumerates the dependency (out) edges of the given resource.
          * @param resource The resource to enumerate dependency edges for.
@@ -178,10 +227,30 @@ namespace puppet { namespace compiler {
         void populate_graph();
 
         /**
-         * Writes the catalog as JSON.
+         * Writes the catalog.
+         * The catalog is streamed to the output stream as it is generated.
          * @param out The output stream to write the catalog to.
+         * @param format The format to write the catalog in.
+         * @param pretty True to write indented JSON or false to write compact JSON; ignored for other formats.
+         * @param previous The summary of the previous catalog to write the changes since or nullptr to write the entire catalog.
+         */
+        void write(std::ostream& out, catalog_format format = catalog_format::json, bool pretty = true, catalog_summary const* previous = nullptr) const;
+
+        /**
+         * Writes the catalog to a data writer.
+         * Every format is written by this one traversal of the catalog.
+         * @param writer The data writer to write the catalog to.
          */
-        void write(std::ostream& out) const;
+        void write(runtime::data_writer& writer) const;
+
+        /**
+         * Writes the changes to the catalog since a previous catalog to a data writer.
+         * Added and changed resources are written in full; removed resources are written as references.
+         * Added and removed containment edges are also written, along with the content digests of both catalogs.
+         * @param writer The data writer to write the changes to.
+         * @param previous The summary of the previous catalog.
+         */
+        void write(runtime::data_writer& writer, catalog_summary const& previous) const;
 
         /**
          * Writes the dependency graph as a DOT file.
@@ -191,23 +260,49 @@ namespace puppet { namespace compiler {
 
         /**
          * Detects cycles within the graph.
+         * One representative cycle is reported for each strongly connected component that contains a cycle.
          * Throws a resource_cycle_exception if cycles are detected.
          */
         void detect_cycles();
 
      private:
+        friend struct resource;
+
         catalog(catalog&) = delete;
         catalog& operator=(catalog&) = delete;
         void populate_relationships(resource const& source, std::string const& name, compiler::relationship relationship);
+        void index(resource& resource, attribute const& attribute);
+        void rehash(runtime::digest const& previous, runtime::digest const& current);
+
+        struct edge
+        {
+            size_t source;
+            size_t target;
+            compiler::relationship relation;
+
+            bool operator==(edge const& other) const;
+        };
+
+        struct edge_hasher
+        {
+            size_t operator()(edge const& value) const;
+        };
 
+        // The arena is declared first so that it is destroyed after everything that may refer to its memory
+        std::unique_ptr<compiler::arena> _arena;
         std::string _node;
         std::string _environment;
+        runtime::digest _hash;
         // Use a deque to store the resources because deque doesn't invalidate references on push back
         // This enables us to store pointers to resources in various data structures and the dependency graph
         std::deque<resource> _resources;
         std::unordered_map<runtime::types::resource, resource*, boost::hash<runtime::types::resource>> _resource_map;
         std::unordered_map<std::string, std::vector<resource*>> _resource_lists;
+        // Maps type name to attribute name to an index of lowercase string values
+        std::unordered_map<std::string, std::unordered_map<std::string, std::unordered_multimap<std::string, resource*>>> _indexes;
         boost::adjacency_list<boost::vecS, boost::vecS, boost::directedS, resource*, relationship> _graph;
+        // Tracks the edges in the graph so that duplicate relationships are detected without scanning out edges
+        std::unordered_set<edge, edge_hasher> _edges;
     };
 
 }}  // namespace puppet::compiler
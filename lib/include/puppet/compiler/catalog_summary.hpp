@@ -0,0 +1,155 @@
+/**
+ * @file
+ * Declares the catalog summary.
+ */
+#pragma once
+
+#include "../runtime/data_writer.hpp"
+#include "../runtime/digest.hpp"
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+namespace puppet { namespace compiler {
+
+    /**
+     * Represents a summary of a written catalog: its recorded content hash (see catalog::hash), a digest of each of its resources, and its containment edges.
+     * A summary is built by writing a catalog to it or by loading a previously written catalog.
+     * Both produce the same resource digests for the same content, so summaries can be compared to find what changed between compilations.
+     */
+    struct catalog_summary : runtime::data_writer
+    {
+        using data_writer::string;
+        using data_writer::key;
+
+        /**
+         * Represents a containment edge as the references of the source and target resources.
+         */
+        using edge = std::pair<std::string, std::string>;
+
+        /**
+         * Constructs an empty catalog summary.
+         */
+        catalog_summary();
+
+        /**
+         * Loads the summary of a previously written catalog.
+         * The format of the catalog (JSON or CBOR) is detected from its content.
+         * @param path The path to the catalog file.
+         * @return Returns true if the catalog was loaded or false if the file cannot be read or is not a valid catalog.
+         */
+        bool load(std::string const& path);
+
+        /**
+         * Determines if the summary is empty (no catalog has been written to it).
+         * @return Returns true if the summary is empty or false if not.
+         */
+        bool empty() const;
+
+        /**
+         * Gets the content hash recorded in the catalog (see catalog::hash).
+         * @return Returns the recorded content hash or an empty string if the catalog did not record one.
+         */
+        std::string const& catalog_hash() const;
+
+        /**
+         * Finds the digest of a resource.
+         * @param reference The resource reference (e.g. "File[/tmp/foo]").
+         * @return Returns the digest of the resource or nullptr if the catalog does not contain the resource.
+         */
+        runtime::digest const* find(std::string const& reference) const;
+
+        /**
+         * Gets the digests of the catalog's resources, keyed by resource reference.
+         * @return Returns the digests of the catalog's resources.
+         */
+        std::map<std::string, runtime::digest> const& resources() const;
+
+        /**
+         * Gets the catalog's containment edges.
+         * @return Returns the catalog's containment edges.
+         */
+        std::set<edge> const& edges() const;
+
+        /**
+         * Writes a null value.
+         */
+        void null() override;
+
+        /**
+         * Writes a boolean value.
+         * @param value The value to write.
+         */
+        void boolean(bool value) override;
+
+        /**
+         * Writes an integer value.
+         * @param value The value to write.
+         */
+        void number(std::int64_t value) override;
+
+        /**
+         * Writes a floating point value.
+         * @param value The value to write.
+         */
+        void number(double value) override;
+
+        /**
+         * Writes a string value.
+         * @param value The value to write.
+         * @param size The size of the value, in bytes.
+         */
+        void string(char const* value, size_t size) override;
+
+        /**
+         * Writes the key of an object member.
+         * @param name The name of the member.
+         * @param size The size of the name, in bytes.
+         */
+        void key(char const* name, size_t size) override;
+
+        /**
+         * Starts writing an object.
+         */
+        void start_object() override;
+
+        /**
+         * Ends writing an object.
+         */
+        void end_object() override;
+
+        /**
+         * Starts writing an array.
+         */
+        void start_array() override;
+
+        /**
+         * Ends writing an array.
+         */
+        void end_array() override;
+
+        /**
+         * Flushes any buffered output.
+         * This has no effect for a catalog summary.
+         */
+        void flush() override;
+
+     private:
+        bool in_item() const;
+        void start_item();
+        void end_item();
+
+        runtime::digest_writer _item_hash;
+        std::map<std::string, runtime::digest> _resources;
+        std::set<edge> _edges;
+        std::string _catalog_hash;
+        std::string _section;
+        std::string _member;
+        std::string _first;
+        std::string _second;
+        size_t _depth;
+        bool _empty;
+    };
+
+}}  // namespace puppet::compiler
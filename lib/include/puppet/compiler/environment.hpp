@@ -9,11 +9,15 @@
 #include "registry.hpp"
 #include "module.hpp"
 #include "finder.hpp"
+#include "ast_cache.hpp"
 #include "evaluation/dispatcher.hpp"
 #include "../logging/logger.hpp"
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <cstdint>
+#include <ctime>
 #include <unordered_map>
 
 namespace puppet { namespace compiler {
@@ -27,6 +31,8 @@ namespace puppet { namespace compiler {
 
     /**
      * Represents a compilation environment.
+     * An environment may be shared by nodes being compiled on different threads; modules are loaded upon construction
+     * and files are imported lazily under a lock.
      */
     struct environment : finder
     {
@@ -90,16 +96,52 @@ namespace puppet { namespace compiler {
          */
         void import(logging::logger& logger, find_type type, std::string const& name);
 
+        /**
+         * Preloads the environment by parsing the environment's manifests and the manifests of every module concurrently.
+         * Preloaded files are only registered when imported, so name resolution is unchanged.
+         * This is done once; refreshing a preloaded environment also preloads any files that were added.
+         * @param logger The logger to use to log messages.
+         */
+        void preload(logging::logger& logger);
+
+        /**
+         * Refreshes the environment by re-parsing any previously parsed file that has changed on disk.
+         * Definitions from changed or removed files are unregistered before the changed files are imported again in path order.
+         * Files that were only preloaded are parsed again but not imported.
+         * Module files are also indexed again to pick up added or removed files.
+         * This must not be called while any compilation using the environment is in progress.
+         * @param logger The logger to use to log messages.
+         * @return Returns the number of files that were changed or removed.
+         */
+        size_t refresh(logging::logger& logger);
+
      private:
+        struct parsed_file
+        {
+            std::shared_ptr<ast::syntax_tree> tree;
+            compiler::module const* module;
+            std::time_t modified;
+            std::uintmax_t size;
+            bool imported;
+        };
+
         void load_modules(logging::logger& logger, std::string const& directory);
+        std::vector<std::string> find_manifests(logging::logger& logger) const;
+        size_t refresh_files(logging::logger& logger);
         std::shared_ptr<ast::syntax_tree> import(logging::logger& logger, std::string const& path, compiler::module const* module = nullptr);
+        std::shared_ptr<ast::syntax_tree> parse(logging::logger& logger, std::string const& path, compiler::module const* module);
+        void parse_all(logging::logger& logger, std::vector<std::pair<std::string, compiler::module const*>> files);
+        static bool stat(std::string const& path, std::time_t& modified, std::uintmax_t& size);
 
         compiler::settings const& _settings;
         std::string _name;
         compiler::registry _registry;
         evaluation::dispatcher _dispatcher;
-        std::unordered_map<std::string, std::shared_ptr<ast::syntax_tree>> _parsed;
+        std::mutex _mutex;
+        std::unordered_map<std::string, parsed_file> _parsed;
+        std::unique_ptr<ast_cache> _cache;
         std::unordered_map<std::string, module> _modules;
+        bool _preloaded;
     };
 
 }}  // puppet::compiler
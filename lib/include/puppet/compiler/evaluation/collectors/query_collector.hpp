@@ -5,8 +5,11 @@
 #pragma once
 
 #include "collector.hpp"
+#include "query_evaluator.hpp"
 #include "../scope.hpp"
 #include "../../ast/ast.hpp"
+#include <memory>
+#include <unordered_set>
 
 namespace puppet { namespace compiler { namespace evaluation { namespace collectors {
 
@@ -29,9 +32,13 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
         void collect(evaluation::context& context) override;
 
      private:
+        ast::attribute_query const* indexed_query() const;
+
         compiler::ast::collector_expression const& _expression;
         std::shared_ptr<scope> _scope;
         size_t _index;
+        std::unordered_set<compiler::resource const*> _collected;
+        std::unique_ptr<query_evaluator> _evaluator;
     };
 
 }}}}  // namespace puppet::compiler::evaluation::collectors
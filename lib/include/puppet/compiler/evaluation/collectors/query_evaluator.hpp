@@ -7,6 +7,8 @@
 #include "../../ast/ast.hpp"
 #include "../../resource.hpp"
 #include <boost/optional.hpp>
+#include <unordered_map>
+#include <vector>
 
 namespace puppet { namespace compiler { namespace evaluation {
 
@@ -19,11 +21,14 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
 
     /**
      * Represents a collection query evaluator.
+     * The query's operands are evaluated once when the evaluator is constructed so that matching a resource is only
+     * an attribute lookup and comparison.
      */
     struct query_evaluator
     {
         /**
          * Constructs a query evaluator given the query to evaluate.
+         * The query's operands are evaluated in the context's current scope.
          * @param context The current evaluation context.
          * @param expression The query expression to evaluate.
          */
@@ -36,7 +41,28 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
          */
         bool evaluate(compiler::resource const& resource) const;
 
+        /**
+         * Determines if the query has operands that may evaluate differently each time (e.g. function calls).
+         * @return Returns true if the query has dynamic operands or false if every operand is constant.
+         */
+        bool dynamic() const;
+
+        /**
+         * Re-evaluates the query's dynamic operands in the context's current scope.
+         */
+        void update();
+
+        /**
+         * Gets the evaluated operand of an attribute query in the query expression.
+         * @param query The attribute query to get the operand of.
+         * @return Returns the evaluated operand.
+         */
+        runtime::values::value const& operand(ast::attribute_query const& query) const;
+
      private:
+        void compile(ast::collector_query_expression const& expression);
+        void compile(ast::attribute_query_expression const& expression);
+        bool evaluate(ast::collector_query_expression const& expression, compiler::resource const& resource) const;
         bool evaluate(ast::attribute_query_expression const& expression, compiler::resource const& resource) const;
         void climb_expression(
             bool& result,
@@ -46,9 +72,12 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
             compiler::resource const& resource) const;
         static uint8_t get_precedence(ast::binary_query_operator op);
         static bool is_right_associative(ast::binary_query_operator op);
+        static bool is_constant(ast::primary_expression const& expression);
 
         evaluation::context& _context;
         boost::optional<ast::collector_query_expression> const& _expression;
+        std::unordered_map<ast::attribute_query const*, runtime::values::value> _operands;
+        std::vector<ast::attribute_query const*> _dynamic;
     };
 
 }}}}  // namespace puppet::compiler::evaluation::collectors
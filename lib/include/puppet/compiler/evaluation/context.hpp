@@ -411,7 +411,7 @@ namespace puppet { namespace compiler { namespace evaluation {
          * @param import Specifies whether or not an attempt to import the class should be made.
          * @return Returns the class definitions or nullptr if the class is not defined.
          */
-        std::vector<klass> const* find_class(std::string name, bool import = true);
+        std::shared_ptr<std::vector<klass> const> find_class(std::string name, bool import = true);
 
         /**
          * Finds a defined type definition by name.
@@ -143,4 +143,16 @@ namespace puppet { namespace compiler {
         explicit settings_exception(std::string const& message);
     };
 
+    /**
+     * Exception for compile server errors.
+     */
+    struct server_exception : std::runtime_error
+    {
+        /**
+         * Creates a server exception.
+         * @param message The exception message.
+         */
+        explicit server_exception(std::string const& message);
+    };
+
 }}  // puppet::compiler
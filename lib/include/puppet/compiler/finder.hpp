@@ -4,8 +4,10 @@
  */
 #pragma once
 
+#include <functional>
 #include <string>
 #include <memory>
+#include <unordered_map>
 
 namespace puppet { namespace compiler {
 
@@ -45,8 +47,25 @@ namespace puppet { namespace compiler {
          */
         std::string find(find_type type, std::string const& name) const;
 
+        /**
+         * Indexes the files that can be found by the finder.
+         * Once indexed, finding a file does not access the file system; index again to pick up added or removed files.
+         * Symlinked directories are followed, but not when they link to a directory that contains them.
+         */
+        void index();
+
+        /**
+         * Enumerates the indexed files of the given type.
+         * Files are enumerated in no particular order; nothing is enumerated if the finder has not been indexed.
+         * @param type The type of file to enumerate.
+         * @param callback The callback to call with each file's qualified name and path; return false to stop enumerating.
+         */
+        void each(find_type type, std::function<bool(std::string const&, std::string const&)> const& callback) const;
+
      private:
         std::string _directory;
+        bool _indexed;
+        std::unordered_map<std::string, std::string> _manifests;
     };
 
 }}  // puppet::compiler
@@ -10,6 +10,9 @@
 #include "../runtime/values/value.hpp"
 #include <memory>
 #include <vector>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_set>
 #include <unordered_map>
 #include <boost/optional.hpp>
@@ -135,6 +138,10 @@ namespace puppet { namespace compiler {
      * Represents the type registry.
      * Note: the registry assumes that any syntax tree imported into it will outlive the registry; it does not
      * take a shared pointer on any tree.
+     * The registry is safe to use from multiple threads: imports are serialized and lookups may happen concurrently
+     * with an import. Pointers to defined types and node definitions returned by lookups are only valid until the
+     * next unregister (i.e. the next environment refresh); callers must hold the compilation lock of the environment's
+     * owner (e.g. the compile server's refresh gate) for as long as they use them.
      */
     struct registry
     {
@@ -143,17 +150,6 @@ namespace puppet { namespace compiler {
          */
         registry() = default;
 
-        /**
-         * Default move constructor for registry.
-         */
-        registry(registry&&) = default;
-
-        /**
-         * Default move assignment operator for registry.
-         * @return Returns this registry.
-         */
-        registry& operator=(registry&&) = default;
-
         /**
          * Imports a syntax tree into the registry.
          * Throws parse_exception if the tree cannot be successfully imported.
@@ -161,12 +157,21 @@ namespace puppet { namespace compiler {
          */
         void import(ast::syntax_tree const& tree);
 
+        /**
+         * Unregisters the classes, defined types, and node definitions that were imported from the given syntax tree.
+         * This invalidates any pointer previously returned by find_defined_type or find_node.
+         * This must not be called while any compilation using the registry is in progress.
+         * @param tree The syntax tree to unregister.
+         */
+        void unregister(ast::syntax_tree const& tree);
+
         /**
          * Finds a class given the qualified name.
          * @param name The fully-qualified name of the class (e.g. foo::bar).
-         * @return Returns a pointer to the class definitions if found or nullptr if the class does not exist.
+         * The definitions are shared and never modified, so they remain valid if the class is registered again or unregistered.
+         * @return Returns the class definitions if found or nullptr if the class does not exist.
          */
-        std::vector<klass> const* find_class(std::string const& name) const;
+        std::shared_ptr<std::vector<klass> const> find_class(std::string const& name) const;
 
         /**
          * Registers a class.
@@ -177,6 +182,7 @@ namespace puppet { namespace compiler {
         /**
          * Finds a defined type given the qualified name.
          * @param name The fully-qualified name of the defined type (e.g. foo::bar).
+         * The pointer is only valid until the next call to unregister.
          * @return Returns a pointer to the defined type or nullptr if the defined type does not exist.
          */
         defined_type const* find_defined_type(std::string const& name) const;
@@ -190,6 +196,7 @@ namespace puppet { namespace compiler {
 
         /**
          * Finds a matching node definition and scope name for the given node.
+         * The node definition is only valid until the next call to unregister.
          * @param node The node to find the node definition for.
          * @return Returns the pair of node definition and matching name if found or a nullptt if one does not exist.
          */
@@ -197,6 +204,7 @@ namespace puppet { namespace compiler {
 
         /**
          * Finds a matching node definition for the given node expression.
+         * The pointer is only valid until the next call to unregister.
          * @param expression The node expression to find a matching node definition for.
          * @return Returns a pointer to the node definition if found or nullptr if one does not exist.
          */
@@ -212,11 +220,15 @@ namespace puppet { namespace compiler {
      private:
         registry(registry&) = delete;
         registry& operator=(registry&) = delete;
+        node_definition const* find_node_unlocked(ast::node_expression const& expression) const;
 
+        std::mutex _import_mutex;
+        mutable std::shared_timed_mutex _mutex;
         std::unordered_set<ast::syntax_tree const*> _imported;
-        std::unordered_map<std::string, std::vector<klass>> _classes;
+        std::unordered_map<std::string, std::shared_ptr<std::vector<klass> const>> _classes;
         std::unordered_map<std::string, defined_type> _defined_types;
-        std::vector<node_definition> _nodes;
+        // Use a deque so that node definition pointers are not invalidated by later registrations
+        std::deque<node_definition> _nodes;
         std::unordered_map<std::string, size_t> _named_nodes;
         std::vector<std::pair<runtime::values::regex, size_t>> _regex_nodes;
         boost::optional<size_t> _default_node_index;
@@ -5,10 +5,11 @@
 #pragma once
 
 #include "attribute.hpp"
+#include "../runtime/digest.hpp"
 #include <string>
 #include <memory>
 #include <functional>
-#include <set>
+#include <vector>
 #include <unordered_map>
 
 namespace puppet { namespace compiler {
@@ -17,23 +18,44 @@ namespace puppet { namespace compiler {
     struct catalog;
 
     /**
-     * Utility class for tag_set.
+     * Represents an immutable set of tags.
+     * A tag set holds only the tags of its own resource and shares the tag set of the resource's container.
      */
-    struct indirect_less
+    struct tag_set
     {
         /**
-         * Determines if one indirected string is "less than" another.
-         * @param left The left string to compare.
-         * @param right The right string to compare.
-         * @return Returns true if the left is less than the right or false if not.
+         * Constructs a tag set.
+         * @param tags The tags of the resource.
+         * @param parent The tag set of the resource's container or nullptr if the resource has no container.
          */
-        bool operator()(std::string const* left, std::string const* right) const;
-    };
+        tag_set(std::vector<std::string> tags, std::shared_ptr<tag_set const> parent);
 
-    /**
-     * Represents a set of tags (pointers to data stored within each resource).
-     */
-    using tag_set = std::set<std::string const*, indirect_less>;
+        /**
+         * Gets the tag set of the resource's container.
+         * @return Returns the tag set of the container or nullptr if the resource has no container.
+         */
+        std::shared_ptr<tag_set const> const& parent() const;
+
+        /**
+         * Determines if the set contains the given tag.
+         * @param tag The tag to check for.
+         * @return Returns true if the set or any parent set contains the tag or false if not.
+         */
+        bool contains(std::string const& tag) const;
+
+        /**
+         * Gets every tag in the set, including the tags of parent sets.
+         * The tags are computed on first use and shared with the tag sets of contained resources.
+         * @return Returns the sorted tags in the set.
+         */
+        std::vector<std::string> const& all() const;
+
+     private:
+        std::vector<std::string> _tags;
+        std::shared_ptr<tag_set const> _parent;
+        mutable std::vector<std::string> _all;
+        mutable bool _flattened;
+    };
 
     /**
      * Represents a declared resource in a catalog.
@@ -112,7 +134,7 @@ namespace puppet { namespace compiler {
         void apply(compiler::attributes const& attributes, bool override = false);
 
         /**
-         * Enumerates each attribute in the resource.
+         * Enumerates each attribute in the resource in order of name.
          * @param callback The callback to call for each attribute.
          */
         void each_attribute(std::function<bool(attribute const&)> const& callback) const;
@@ -124,10 +146,19 @@ namespace puppet { namespace compiler {
         void tag(std::string tag);
 
         /**
-         * Calculates the tags for the resource.
+         * Gets the tags for the resource.
+         * The tag set is cached and only rebuilt when the tags of the resource or one of its containers change.
          * @return Returns the tag set for the resource.
          */
-        tag_set calculate_tags() const;
+        std::shared_ptr<tag_set const> tags() const;
+
+        /**
+         * Gets the digest of the resource's content: its type, title, file, line, whether it is exported, its own tags, and its attributes.
+         * Tags inherited from containers are covered by the containers' digests and the containment edges of the catalog.
+         * The digest does not depend on the order the attributes were set or the tags were added in.
+         * @return Returns the digest of the resource's content.
+         */
+        runtime::digest hash() const;
 
         /**
          * Determines if the given name is a metaparameter name.
@@ -139,20 +170,29 @@ namespace puppet { namespace compiler {
      private:
         friend struct catalog;
 
-        resource(runtime::types::resource type, resource const* container, ast::context const* context, bool exported);
-        runtime::values::json_value to_json(runtime::values::json_allocator& allocator, compiler::catalog const& catalog) const;
-        void add_relationship_parameters(runtime::values::json_value& parameters, runtime::values::json_allocator& allocator, compiler::catalog const& catalog) const;
+        resource(compiler::catalog* catalog, runtime::types::resource type, resource const* container, ast::context const* context, bool exported);
+        void write(runtime::data_writer& writer, compiler::catalog const& catalog) const;
+        std::vector<std::shared_ptr<attribute>>::const_iterator find(std::string const& name) const;
         void realize(size_t vertex_id);
         size_t vertex_id() const;
-        void populate_tags(tag_set& tags) const;
+        bool add_tag(std::string tag);
 
         std::shared_ptr<ast::syntax_tree> _tree;
+        compiler::catalog* _catalog;
         runtime::types::resource _type;
         resource const* _container;
         ast::context const* _context;
         size_t _vertex_id;
-        std::unordered_map<std::string, std::shared_ptr<attribute>> _attributes;
+        // Attributes are kept sorted by name; resources typically have few attributes, so a flat vector is smaller and faster than a hash
+        std::vector<std::shared_ptr<attribute>> _attributes;
+        // The digest of each attribute, in the same order as the attributes, and their sum
+        std::vector<runtime::digest> _attribute_hashes;
+        runtime::digest _attributes_hash;
+        // The resource's own tags, without duplicates, and the sum of their digests
         std::vector<std::string> _tags;
+        runtime::digest _tags_hash;
+        mutable std::shared_ptr<tag_set const> _tag_set;
+        mutable bool _tags_changed;
         bool _exported;
     };
 
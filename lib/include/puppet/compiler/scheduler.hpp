@@ -0,0 +1,79 @@
+/**
+ * @file
+ * Declares the compilation scheduler.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace puppet { namespace compiler {
+
+    /**
+     * Represents a work-stealing scheduler used to compile nodes concurrently.
+     * Each worker thread owns a queue of tasks; idle workers steal tasks from the other queues.
+     */
+    struct scheduler
+    {
+        /**
+         * Constructs a scheduler.
+         * @param threads The number of worker threads to use; if zero, the number of hardware threads is used.
+         */
+        explicit scheduler(size_t threads = 0);
+
+        /**
+         * Destructs the scheduler.
+         * Waits for all queued tasks to complete before joining the worker threads.
+         */
+        ~scheduler();
+
+        /**
+         * Gets the number of worker threads.
+         * @return Returns the number of worker threads.
+         */
+        size_t threads() const;
+
+        /**
+         * Queues a task to be run on a worker thread.
+         * @param task The task to queue.
+         */
+        void queue(std::function<void()> task);
+
+        /**
+         * Waits for all queued tasks to complete.
+         * If a task threw an exception, the first exception is rethrown.
+         */
+        void wait();
+
+     private:
+        struct work_queue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        scheduler(scheduler&) = delete;
+        scheduler& operator=(scheduler&) = delete;
+        void run(size_t index);
+        bool take(size_t index, std::function<void()>& task);
+
+        std::vector<std::unique_ptr<work_queue>> _queues;
+        std::vector<std::thread> _threads;
+        std::mutex _mutex;
+        std::condition_variable _available;
+        std::condition_variable _finished;
+        std::atomic<size_t> _queued;
+        size_t _pending;
+        size_t _next;
+        bool _stopping;
+        std::exception_ptr _exception;
+    };
+
+}}  // namespace puppet::compiler
@@ -0,0 +1,81 @@
+/**
+ * @file
+ * Declares the compile server.
+ */
+#pragma once
+
+#include "environment.hpp"
+#include "scheduler.hpp"
+#include "../logging/logger.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace puppet { namespace compiler {
+
+    /**
+     * Represents a compile server that listens on a local socket.
+     * The environment is loaded once and shared by every request so that parsed manifests and definitions stay warm.
+     * Each request is the node name on the first line followed by the node's facts in YAML.
+     * The request ends when the client shuts down its side of the connection for writing (e.g. shutdown(fd, SHUT_WR)).
+     * The compiled catalog is written back as JSON; on failure, a JSON object with an "error" member is written instead.
+     * Changed manifests are picked up by refreshing the environment between requests while no compilation is in progress.
+ * Once a refresh is due, new compilations wait for running compilations to finish and for the refresh to complete.
+     */
+    struct server
+    {
+        /**
+         * Constructs a compile server.
+         * @param logger The logger to use.
+         * @param environment The environment to compile nodes with.
+         * @param path The path of the local socket to listen on.
+         * @param threads The number of requests to handle concurrently; if zero, the number of hardware threads is used.
+         * @param compact True to write catalogs as compact JSON or false to write indented JSON.
+         */
+        server(logging::logger& logger, std::shared_ptr<compiler::environment> environment, std::string path, size_t threads = 0, bool compact = false);
+
+        /**
+         * Destructs the compile server.
+         * Closes the socket and removes the socket file.
+         */
+        ~server();
+
+        /**
+         * Gets the path of the local socket.
+         * @return Returns the path of the local socket.
+         */
+        std::string const& path() const;
+
+        /**
+         * Runs the server until interrupted.
+         * Throws server_exception if the socket cannot be created.
+         */
+        void run();
+
+     private:
+        server(server&) = delete;
+        server& operator=(server&) = delete;
+        void handle(int descriptor);
+        void compile(std::ostream& output, std::string const& request);
+        void refresh();
+        void start_compilation();
+        void finish_compilation();
+
+        logging::logger& _logger;
+        std::shared_ptr<compiler::environment> _environment;
+        std::string _path;
+        int _descriptor;
+        bool _compact;
+        std::mutex _mutex;
+        std::condition_variable _changed;
+        size_t _compiling;
+        bool _refresh_pending;
+        bool _refreshing;
+        std::chrono::steady_clock::time_point _refreshed;
+        compiler::scheduler _scheduler;
+    };
+
+}}  // namespace puppet::compiler
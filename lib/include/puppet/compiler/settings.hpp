@@ -12,6 +12,9 @@
 
 namespace puppet { namespace compiler {
 
+    // Forward declaration of catalog_format
+    enum class catalog_format;
+
     /**
      * Represents the settings for the Puppet compiler.
      */
@@ -29,6 +32,12 @@ namespace puppet { namespace compiler {
          */
         settings(int argc, char const* argv[]);
 
+        /**
+         * Gets the directory used to cache parsed syntax trees.
+         * @return Returns the AST cache directory or an empty string if syntax trees are not cached.
+         */
+        std::string const& ast_cache_directory() const;
+
         /**
          * Gets the code directory ($codedir).
          * Defaults to a platform-specific directory.
@@ -68,12 +77,58 @@ namespace puppet { namespace compiler {
          */
         std::string const& node_name() const;
 
+        /**
+         * Gets the directory containing the YAML facts files of the nodes to compile.
+         * If set, a catalog is compiled for each facts file in the directory using a single environment.
+         * @return Returns the nodes directory or an empty string if compiling for a single node.
+         */
+        std::string const& nodes_directory() const;
+
+        /**
+         * Gets the path of the local socket to listen on for compilation requests.
+         * If set, the environment is loaded once and catalogs are compiled on request.
+         * @return Returns the socket path or an empty string if not running as a compile server.
+         */
+        std::string const& socket_path() const;
+
         /**
          * Gets the path to the output file.
          * @return Returns the path to the output file.
          */
         std::string const& output_file() const;
 
+        /**
+         * Gets the number of nodes to compile concurrently when compiling multiple nodes.
+         * Defaults to the number of hardware threads.
+         * @return Returns the number of nodes to compile concurrently.
+         */
+        size_t jobs() const;
+
+        /**
+         * Gets the directory to write catalogs to when compiling multiple nodes.
+         * @return Returns the output directory or an empty string if catalogs are written to the current directory.
+         */
+        std::string const& output_directory() const;
+
+        /**
+         * Gets the path to the previously compiled catalog to write changes since.
+         * When compiling from a nodes directory, this is the directory containing each node's previously compiled catalog.
+         * @return Returns the path to the previous catalog or an empty string if no changes are written.
+         */
+        std::string const& previous_path() const;
+
+        /**
+         * Gets the format compiled catalogs are written in.
+         * @return Returns the format compiled catalogs are written in.
+         */
+        catalog_format output_format() const;
+
+        /**
+         * Gets whether or not compiled catalogs are written as compact JSON.
+         * @return Returns true if catalogs are written as compact JSON or false if they are indented.
+         */
+        bool compact_output() const;
+
         /**
          * Gets the path to the graph file.
          * @return Returns the path to the graph file.
@@ -135,12 +190,20 @@ namespace puppet { namespace compiler {
         void parse(int argc, char const* argv[]);
 
         std::string _code_directory;
+        std::string _ast_cache_directory;
         std::string _environment;
         std::string _environment_directory;
         std::vector<std::string> _module_directories;
         std::vector<std::string> _manifests;
         std::string _node_name;
+        std::string _nodes_directory;
+        std::string _socket_path;
+        size_t _jobs;
         std::string _output_file;
+        std::string _output_directory;
+        std::string _previous_path;
+        catalog_format _output_format;
+        bool _compact_output;
         std::string _graph_file;
         std::shared_ptr<facts::provider> _facts;
         logging::level _log_level;
@@ -10,6 +10,7 @@
 #include <memory>
 #include <functional>
 #include <exception>
+#include <istream>
 
 namespace YAML {
 
@@ -77,6 +78,13 @@ namespace puppet { namespace facts {
          */
         yaml(std::string const& path);
 
+        /**
+         * Constructs a YAML fact provider from the given input stream.
+         * @param stream The stream containing the YAML facts.
+         * @param path The path to report in parse errors.
+         */
+        yaml(std::istream& stream, std::string const& path);
+
         /**
          * Looks up a fact value by name.
          * @param name The name of the fact to look up.
@@ -8,6 +8,8 @@
 #include <string>
 #include <iostream>
 #include <functional>
+#include <mutex>
+#include <atomic>
 
 namespace puppet { namespace logging {
 
@@ -201,8 +203,9 @@ namespace puppet { namespace logging {
             log(level, line, column, text, path, message, std::forward<TArgs>(args)...);
         }
 
-        size_t _warnings;
-        size_t _errors;
+        std::mutex _mutex;
+        std::atomic<size_t> _warnings;
+        std::atomic<size_t> _errors;
         logging::level _level;
     };
 
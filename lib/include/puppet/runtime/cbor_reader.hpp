@@ -0,0 +1,24 @@
+/**
+ * @file
+ * Declares the CBOR reader.
+ */
+#pragma once
+
+#include "data_writer.hpp"
+#include <cstddef>
+
+namespace puppet { namespace runtime {
+
+    /**
+     * Reads CBOR (RFC 7049) data and replays it to a data writer.
+     * This supports the subset of CBOR produced by cbor_writer: integers, floats, text strings, booleans, null, and
+     * definite or indefinite length arrays and maps with text string keys.
+     * Writing the data to a json_writer converts it to JSON.
+     * @param data The CBOR data to read.
+     * @param size The size of the data, in bytes.
+     * @param writer The writer to replay the data to.
+     * @return Returns true if the data was a single valid CBOR item or false if the data is invalid or unsupported.
+     */
+    bool read_cbor(char const* data, size_t size, data_writer& writer);
+
+}}  // namespace puppet::runtime
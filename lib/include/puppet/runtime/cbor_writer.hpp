@@ -0,0 +1,107 @@
+/**
+ * @file
+ * Declares the streaming CBOR writer.
+ */
+#pragma once
+
+#include "data_writer.hpp"
+#include <ostream>
+
+namespace puppet { namespace runtime {
+
+    /**
+     * Represents a streaming CBOR (RFC 7049) writer.
+     * Objects and arrays are written with indefinite lengths so that they can be streamed without knowing their sizes.
+     */
+    struct cbor_writer : data_writer
+    {
+        using data_writer::string;
+        using data_writer::key;
+
+        /**
+         * Constructs a CBOR writer.
+         * @param out The output stream to write to.
+         */
+        explicit cbor_writer(std::ostream& out);
+
+        /**
+         * Destructs the CBOR writer.
+         * Any buffered output is flushed to the output stream.
+         */
+        ~cbor_writer() override;
+
+        /**
+         * Writes a null value.
+         */
+        void null() override;
+
+        /**
+         * Writes a boolean value.
+         * @param value The value to write.
+         */
+        void boolean(bool value) override;
+
+        /**
+         * Writes an integer value.
+         * @param value The value to write.
+         */
+        void number(std::int64_t value) override;
+
+        /**
+         * Writes a floating point value.
+         * @param value The value to write.
+         */
+        void number(double value) override;
+
+        /**
+         * Writes a string value.
+         * @param value The value to write.
+         * @param size The size of the value, in bytes.
+         */
+        void string(char const* value, size_t size) override;
+
+        /**
+         * Writes the key of an object member.
+         * @param name The name of the member.
+         * @param size The size of the name, in bytes.
+         */
+        void key(char const* name, size_t size) override;
+
+        /**
+         * Starts writing an object.
+         */
+        void start_object() override;
+
+        /**
+         * Ends writing an object.
+         */
+        void end_object() override;
+
+        /**
+         * Starts writing an array.
+         */
+        void start_array() override;
+
+        /**
+         * Ends writing an array.
+         */
+        void end_array() override;
+
+        /**
+         * Flushes any buffered output to the output stream.
+         */
+        void flush() override;
+
+     private:
+        cbor_writer(cbor_writer&) = delete;
+        cbor_writer& operator=(cbor_writer&) = delete;
+        void write_head(std::uint8_t major, std::uint64_t value);
+        void write(char const* data, size_t size);
+        void put(std::uint8_t byte);
+
+        std::ostream& _out;
+        size_t _size;
+        char _buffer[64 * 1024];
+    };
+
+}}  // namespace puppet::runtime
@@ -0,0 +1,105 @@
+/**
+ * @file
+ * Declares the structured data writer interface.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace puppet { namespace runtime {
+
+    /**
+     * Represents a streaming writer of structured data (objects, arrays and scalars).
+     * Implementations encode the data as it is given, so the same traversal can produce any supported format.
+     */
+    struct data_writer
+    {
+        /**
+         * Destructs the data writer.
+         */
+        virtual ~data_writer() = default;
+
+        /**
+         * Writes a null value.
+         */
+        virtual void null() = 0;
+
+        /**
+         * Writes a boolean value.
+         * @param value The value to write.
+         */
+        virtual void boolean(bool value) = 0;
+
+        /**
+         * Writes an integer value.
+         * @param value The value to write.
+         */
+        virtual void number(std::int64_t value) = 0;
+
+        /**
+         * Writes a floating point value.
+         * @param value The value to write.
+         */
+        virtual void number(double value) = 0;
+
+        /**
+         * Writes a string value.
+         * @param value The value to write.
+         * @param size The size of the value, in bytes.
+         */
+        virtual void string(char const* value, size_t size) = 0;
+
+        /**
+         * Writes a string value.
+         * @param value The value to write.
+         */
+        void string(std::string const& value)
+        {
+            string(value.data(), value.size());
+        }
+
+        /**
+         * Writes the key of an object member.
+         * @param name The name of the member.
+         * @param size The size of the name, in bytes.
+         */
+        virtual void key(char const* name, size_t size) = 0;
+
+        /**
+         * Writes the key of an object member.
+         * @param name The name of the member.
+         */
+        void key(std::string const& name)
+        {
+            key(name.data(), name.size());
+        }
+
+        /**
+         * Starts writing an object.
+         */
+        virtual void start_object() = 0;
+
+        /**
+         * Ends writing an object.
+         */
+        virtual void end_object() = 0;
+
+        /**
+         * Starts writing an array.
+         */
+        virtual void start_array() = 0;
+
+        /**
+         * Ends writing an array.
+         */
+        virtual void end_array() = 0;
+
+        /**
+         * Flushes any buffered output.
+         */
+        virtual void flush() = 0;
+    };
+
+}}  // namespace puppet::runtime
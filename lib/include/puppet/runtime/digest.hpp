@@ -0,0 +1,185 @@
+/**
+ * @file
+ * Declares the content digest and the digest writer.
+ */
+#pragma once
+
+#include "data_writer.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace puppet { namespace runtime {
+
+    /**
+     * Represents a 128-bit content digest.
+     * Digests are stable across runs and platforms, but are not cryptographically secure.
+     */
+    struct digest
+    {
+        /**
+         * Constructs an empty (all zero) digest.
+         */
+        digest();
+
+        /**
+         * Constructs a digest from its two halves.
+         * @param high The high 64 bits of the digest.
+         * @param low The low 64 bits of the digest.
+         */
+        digest(std::uint64_t high, std::uint64_t low);
+
+        /**
+         * Gets the high 64 bits of the digest.
+         * @return Returns the high 64 bits of the digest.
+         */
+        std::uint64_t high() const;
+
+        /**
+         * Gets the low 64 bits of the digest.
+         * @return Returns the low 64 bits of the digest.
+         */
+        std::uint64_t low() const;
+
+        /**
+         * Gets the digest as a string of 32 lowercase hexadecimal digits.
+         * @return Returns the digest as a hexadecimal string.
+         */
+        std::string to_string() const;
+
+        /**
+         * Adds another digest to this digest (modulo 2^128).
+         * Combining digests by addition does not depend on the order they are combined in, and subtracting a digest undoes its addition.
+         * @param other The digest to add.
+         * @return Returns this digest.
+         */
+        digest& operator+=(digest const& other);
+
+        /**
+         * Subtracts another digest from this digest (modulo 2^128).
+         * @param other The digest to subtract.
+         * @return Returns this digest.
+         */
+        digest& operator-=(digest const& other);
+
+     private:
+        std::uint64_t _high;
+        std::uint64_t _low;
+    };
+
+    /**
+     * Equality operator for digest.
+     * @param left The left digest to compare.
+     * @param right The right digest to compare.
+     * @return Returns true if the two digests are equal or false if not.
+     */
+    bool operator==(digest const& left, digest const& right);
+
+    /**
+     * Inequality operator for digest.
+     * @param left The left digest to compare.
+     * @param right The right digest to compare.
+     * @return Returns true if the two digests are not equal or false if they are equal.
+     */
+    bool operator!=(digest const& left, digest const& right);
+
+    /**
+     * Stream insertion operator for digest.
+     * @param os The output stream to write the digest to.
+     * @param value The digest to write.
+     * @return Returns the given output stream.
+     */
+    std::ostream& operator<<(std::ostream& os, digest const& value);
+
+    /**
+     * Represents a data writer that computes a digest of the data written to it.
+     * Each item is hashed along with its kind so that, for example, a key and a string with the same text differ.
+     * The same data produces the same digest regardless of the format it was read from.
+     */
+    struct digest_writer : data_writer
+    {
+        using data_writer::string;
+        using data_writer::key;
+
+        /**
+         * Constructs a digest writer.
+         */
+        digest_writer();
+
+        /**
+         * Gets the digest of the data written so far.
+         * @return Returns the digest of the data written so far.
+         */
+        runtime::digest result() const;
+
+        /**
+         * Writes a null value.
+         */
+        void null() override;
+
+        /**
+         * Writes a boolean value.
+         * @param value The value to write.
+         */
+        void boolean(bool value) override;
+
+        /**
+         * Writes an integer value.
+         * @param value The value to write.
+         */
+        void number(std::int64_t value) override;
+
+        /**
+         * Writes a floating point value.
+         * @param value The value to write.
+         */
+        void number(double value) override;
+
+        /**
+         * Writes a string value.
+         * @param value The value to write.
+         * @param size The size of the value, in bytes.
+         */
+        void string(char const* value, size_t size) override;
+
+        /**
+         * Writes the key of an object member.
+         * @param name The name of the member.
+         * @param size The size of the name, in bytes.
+         */
+        void key(char const* name, size_t size) override;
+
+        /**
+         * Starts writing an object.
+         */
+        void start_object() override;
+
+        /**
+         * Ends writing an object.
+         */
+        void end_object() override;
+
+        /**
+         * Starts writing an array.
+         */
+        void start_array() override;
+
+        /**
+         * Ends writing an array.
+         */
+        void end_array() override;
+
+        /**
+         * Flushes any buffered output.
+         * This has no effect for a digest writer.
+         */
+        void flush() override;
+
+     private:
+        void update(std::uint8_t kind, void const* data = nullptr, size_t size = 0);
+
+        std::uint64_t _high;
+        std::uint64_t _low;
+    };
+
+}}  // namespace puppet::runtime
@@ -0,0 +1,22 @@
+/**
+ * @file
+ * Declares the JSON reader.
+ */
+#pragma once
+
+#include "data_writer.hpp"
+#include <cstddef>
+
+namespace puppet { namespace runtime {
+
+    /**
+     * Reads JSON data and replays it to a data writer.
+     * Numbers without a fraction or exponent are replayed as integers; all other numbers are replayed as floating point.
+     * @param data The JSON data to read.
+     * @param size The size of the data, in bytes.
+     * @param writer The writer to replay the data to.
+     * @return Returns true if the data was a single valid JSON value or false if the data is invalid.
+     */
+    bool read_json(char const* data, size_t size, data_writer& writer);
+
+}}  // namespace puppet::runtime
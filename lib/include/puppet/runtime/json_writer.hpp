@@ -0,0 +1,105 @@
+/**
+ * @file
+ * Declares the streaming JSON writer.
+ */
+#pragma once
+
+#include "data_writer.hpp"
+#include <memory>
+#include <ostream>
+
+namespace puppet { namespace runtime {
+
+    /**
+     * Represents a streaming JSON writer.
+     * Values are written to a buffered output stream as they are given, so no intermediate document is built.
+     */
+    struct json_writer : data_writer
+    {
+        using data_writer::string;
+        using data_writer::key;
+
+        /**
+         * Constructs a JSON writer.
+         * @param out The output stream to write to.
+         * @param pretty True to write indented JSON or false to write compact JSON.
+         */
+        explicit json_writer(std::ostream& out, bool pretty = true);
+
+        /**
+         * Destructs the JSON writer.
+         * Any buffered output is flushed to the output stream.
+         */
+        ~json_writer() override;
+
+        /**
+         * Writes a null value.
+         */
+        void null() override;
+
+        /**
+         * Writes a boolean value.
+         * @param value The value to write.
+         */
+        void boolean(bool value) override;
+
+        /**
+         * Writes an integer value.
+         * @param value The value to write.
+         */
+        void number(std::int64_t value) override;
+
+        /**
+         * Writes a floating point value.
+         * @param value The value to write.
+         */
+        void number(double value) override;
+
+        /**
+         * Writes a string value.
+         * @param value The value to write.
+         * @param size The size of the value, in bytes.
+         */
+        void string(char const* value, size_t size) override;
+
+        /**
+         * Writes the key of an object member.
+         * @param name The name of the member.
+         * @param size The size of the name, in bytes.
+         */
+        void key(char const* name, size_t size) override;
+
+        /**
+         * Starts writing an object.
+         */
+        void start_object() override;
+
+        /**
+         * Ends writing an object.
+         */
+        void end_object() override;
+
+        /**
+         * Starts writing an array.
+         */
+        void start_array() override;
+
+        /**
+         * Ends writing an array.
+         */
+        void end_array() override;
+
+        /**
+         * Flushes any buffered output to the output stream.
+         */
+        void flush() override;
+
+     private:
+        json_writer(json_writer&) = delete;
+        json_writer& operator=(json_writer&) = delete;
+
+        struct state;
+        std::unique_ptr<state> _state;
+    };
+
+}}  // namespace puppet::runtime
@@ -0,0 +1,131 @@
+/**
+ * @file
+ * Declares the interned symbol.
+ */
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace puppet { namespace runtime {
+
+    /**
+     * Represents an interned string.
+     * Equal strings share a single entry in a process-wide table, so symbols compare by pointer and carry a precomputed hash.
+     * Entries are reference counted and removed from the table when the last symbol for the string is destroyed, so the table
+     * only holds strings that are in use (e.g. the resource type names of the catalogs being compiled).
+     */
+    struct symbol
+    {
+        /**
+         * Constructs a symbol for the empty string.
+         */
+        symbol();
+
+        /**
+         * Constructs a symbol by interning the given string.
+         * @param value The string to intern.
+         */
+        explicit symbol(std::string const& value);
+
+        /**
+         * Copy constructor for symbol.
+         * @param other The other symbol to copy.
+         */
+        symbol(symbol const& other);
+
+        /**
+         * Copy assignment operator for symbol.
+         * @param other The other symbol to copy.
+         * @return Returns this symbol.
+         */
+        symbol& operator=(symbol const& other);
+
+        /**
+         * Destructs the symbol.
+         * Removes the interned string from the table if this is the last symbol for it.
+         */
+        ~symbol();
+
+        /**
+         * Gets the interned string.
+         * The reference remains valid for the lifetime of the symbol.
+         * @return Returns the interned string.
+         */
+        std::string const& str() const;
+
+        /**
+         * Gets the precomputed hash of the interned string.
+         * @return Returns the hash of the interned string.
+         */
+        size_t hash() const;
+
+        /**
+         * Determines if the symbol is the empty string.
+         * @return Returns true if the symbol is the empty string or false if not.
+         */
+        bool empty() const;
+
+        /**
+         * Equality operator for symbol.
+         * @param other The other symbol to compare with.
+         * @return Returns true if both symbols are the same string or false if not.
+         */
+        bool operator==(symbol const& other) const;
+
+        /**
+         * Inequality operator for symbol.
+         * @param other The other symbol to compare with.
+         * @return Returns true if the symbols are different strings or false if not.
+         */
+        bool operator!=(symbol const& other) const;
+
+     private:
+        struct entry;
+        struct table;
+
+        static entry* intern(std::string const& value);
+        static void release(entry* value);
+
+        entry* _entry;
+    };
+
+    /**
+     * Stream insertion operator for symbol.
+     * @param os The output stream to write to.
+     * @param value The symbol to write.
+     * @return Returns the given output stream.
+     */
+    std::ostream& operator<<(std::ostream& os, symbol const& value);
+
+    /**
+     * Hashes the symbol.
+     * @param value The symbol to hash.
+     * @return Returns the precomputed hash of the symbol.
+     */
+    size_t hash_value(symbol const& value);
+
+}}  // namespace puppet::runtime
+
+namespace std {
+
+    /**
+     * Specialization of std::hash for symbol.
+     */
+    template <>
+    struct hash<puppet::runtime::symbol>
+    {
+        /**
+         * Hashes the symbol.
+         * @param value The symbol to hash.
+         * @return Returns the precomputed hash of the symbol.
+         */
+        size_t operator()(puppet::runtime::symbol const& value) const
+        {
+            return value.hash();
+        }
+    };
+
+}  // namespace std
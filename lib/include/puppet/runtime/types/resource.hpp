@@ -5,6 +5,7 @@
 #pragma once
 
 #include "../values/forward.hpp"
+#include "../symbol.hpp"
 #include <ostream>
 #include <string>
 #include <boost/optional.hpp>
@@ -87,7 +88,10 @@ namespace puppet { namespace runtime { namespace types {
         static boost::optional<resource> parse(std::string const& specification);
 
      private:
-        std::string _type_name;
+        friend bool operator==(resource const& left, resource const& right);
+        friend size_t hash_value(resource const& type);
+
+        symbol _type_name;
         std::string _title;
     };
 
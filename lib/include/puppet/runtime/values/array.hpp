@@ -4,7 +4,8 @@
  */
 #pragma once
 
-#include "wrapper.hpp"
+#include "forward.hpp"
+#include <initializer_list>
 #include <ostream>
 #include <vector>
 #include <memory>
@@ -13,19 +14,409 @@ namespace puppet { namespace runtime { namespace values {
 
     /**
      * Represents a runtime array value.
+     * The elements are stored contiguously in a single allocation rather than each in its own allocation.
+     * The elements are shared between copies of the array and only copied when a copy is modified (copy-on-write).
+     * This makes copying an array O(1); the elements are copied on the first modification of a shared array.
+     * Note: any member that returns a non-const iterator or reference is a modification as it may be used to modify the array.
      */
-    struct array : std::vector<wrapper<value>>
+    struct array
     {
-        // Use the base constructor and assignment semantics
-        using vector::vector;
-        using vector::operator=;
+        /**
+         * The underlying sequence type.
+         * The recursion between value and array is broken by the shared storage, so the elements can be values.
+         */
+        using sequence_type = std::vector<value>;
+
+        /**
+         * The element type of the array.
+         */
+        using value_type = sequence_type::value_type;
+
+        /**
+         * The size type of the array.
+         */
+        using size_type = sequence_type::size_type;
+
+        /**
+         * The difference type of the array.
+         */
+        using difference_type = sequence_type::difference_type;
+
+        /**
+         * The reference type of the array.
+         */
+        using reference = sequence_type::reference;
+
+        /**
+         * The const reference type of the array.
+         */
+        using const_reference = sequence_type::const_reference;
+
+        /**
+         * The iterator type of the array.
+         */
+        using iterator = sequence_type::iterator;
+
+        /**
+         * The const iterator type of the array.
+         */
+        using const_iterator = sequence_type::const_iterator;
+
+        /**
+         * The reverse iterator type of the array.
+         */
+        using reverse_iterator = sequence_type::reverse_iterator;
+
+        /**
+         * The const reverse iterator type of the array.
+         */
+        using const_reverse_iterator = sequence_type::const_reverse_iterator;
+
+        /**
+         * Constructs an empty array.
+         * An empty array does not allocate.
+         */
+        array() = default;
+
+        /**
+         * Constructs an array of undef elements.
+         * @param count The number of elements in the array.
+         */
+        explicit array(size_type count);
+
+        /**
+         * Constructs an array from an initializer list.
+         * @param elements The elements of the array.
+         */
+        array(std::initializer_list<value_type> elements);
+
+        /**
+         * Constructs an array from a range of elements.
+         * @tparam InputIterator The input iterator type.
+         * @param first The beginning of the range.
+         * @param last The end of the range.
+         */
+        template <typename InputIterator>
+        array(InputIterator first, InputIterator last) :
+            _elements(std::make_shared<sequence_type>(first, last))
+        {
+        }
+
+        /**
+         * Copy constructor for array.
+         * The elements are shared with the other array.
+         */
+        array(array const&) = default;
+
+        /**
+         * Move constructor for array.
+         */
+        array(array&&) noexcept = default;
+
+        /**
+         * Copy assignment operator for array.
+         * The elements are shared with the other array.
+         * @return Returns this array.
+         */
+        array& operator=(array const&) = default;
+
+        /**
+         * Move assignment operator for array.
+         * @return Returns this array.
+         */
+        array& operator=(array&&) noexcept = default;
+
+        /**
+         * Gets an iterator to the beginning.
+         * @return Returns an iterator to the beginning.
+         */
+        iterator begin()
+        {
+            return mutate().begin();
+        }
+
+        /**
+         * Gets an iterator to the beginning.
+         * @return Returns an iterator to the beginning.
+         */
+        const_iterator begin() const
+        {
+            return elements().begin();
+        }
+
+        /**
+         * Gets an iterator to the end.
+         * @return Returns an iterator to the end.
+         */
+        iterator end()
+        {
+            return mutate().end();
+        }
+
+        /**
+         * Gets an iterator to the end.
+         * @return Returns an iterator to the end.
+         */
+        const_iterator end() const
+        {
+            return elements().end();
+        }
+
+        /**
+         * Gets a const iterator to the beginning.
+         * @return Returns a const iterator to the beginning.
+         */
+        const_iterator cbegin() const
+        {
+            return elements().cbegin();
+        }
+
+        /**
+         * Gets a const iterator to the end.
+         * @return Returns a const iterator to the end.
+         */
+        const_iterator cend() const
+        {
+            return elements().cend();
+        }
+
+        /**
+         * Gets a reverse iterator to the beginning.
+         * @return Returns a reverse iterator to the beginning.
+         */
+        reverse_iterator rbegin()
+        {
+            return mutate().rbegin();
+        }
+
+        /**
+         * Gets a reverse iterator to the beginning.
+         * @return Returns a reverse iterator to the beginning.
+         */
+        const_reverse_iterator rbegin() const
+        {
+            return elements().rbegin();
+        }
+
+        /**
+         * Gets a reverse iterator to the end.
+         * @return Returns a reverse iterator to the end.
+         */
+        reverse_iterator rend()
+        {
+            return mutate().rend();
+        }
+
+        /**
+         * Gets a reverse iterator to the end.
+         * @return Returns a reverse iterator to the end.
+         */
+        const_reverse_iterator rend() const
+        {
+            return elements().rend();
+        }
+
+        /**
+         * Gets a const reverse iterator to the beginning.
+         * @return Returns a const reverse iterator to the beginning.
+         */
+        const_reverse_iterator crbegin() const
+        {
+            return elements().crbegin();
+        }
+
+        /**
+         * Gets a const reverse iterator to the end.
+         * @return Returns a const reverse iterator to the end.
+         */
+        const_reverse_iterator crend() const
+        {
+            return elements().crend();
+        }
+
+        /**
+         * Gets the size of the array (number of elements).
+         * @return Returns the size of the array.
+         */
+        size_type size() const;
+
+        /**
+         * Determines if the array is empty.
+         * @return Returns true if the array is empty or false if it contains at least one element.
+         */
+        bool empty() const
+        {
+            return !_elements || _elements->empty();
+        }
+
+        /**
+         * Gets the element at the given index.
+         * @param index The index of the element.
+         * @return Returns the element at the given index.
+         */
+        reference operator[](size_type index);
+
+        /**
+         * Gets the element at the given index.
+         * @param index The index of the element.
+         * @return Returns the element at the given index.
+         */
+        const_reference operator[](size_type index) const;
+
+        /**
+         * Gets the element at the given index.
+         * Throws std::out_of_range if the index is out of range.
+         * @param index The index of the element.
+         * @return Returns the element at the given index.
+         */
+        reference at(size_type index);
+
+        /**
+         * Gets the element at the given index.
+         * Throws std::out_of_range if the index is out of range.
+         * @param index The index of the element.
+         * @return Returns the element at the given index.
+         */
+        const_reference at(size_type index) const;
+
+        /**
+         * Gets the first element.
+         * @return Returns the first element.
+         */
+        reference front()
+        {
+            return mutate().front();
+        }
+
+        /**
+         * Gets the first element.
+         * @return Returns the first element.
+         */
+        const_reference front() const
+        {
+            return elements().front();
+        }
+
+        /**
+         * Gets the last element.
+         * @return Returns the last element.
+         */
+        reference back();
+
+        /**
+         * Gets the last element.
+         * @return Returns the last element.
+         */
+        const_reference back() const;
+
+        /**
+         * Reserves storage for the given number of elements.
+         * @param capacity The number of elements to reserve storage for.
+         */
+        void reserve(size_type capacity);
+
+        /**
+         * Resizes the array, adding undef elements if the array grows.
+         * @param count The new size of the array.
+         */
+        void resize(size_type count);
+
+        /**
+         * Removes all elements from the array.
+         */
+        void clear();
+
+        /**
+         * Appends an element to the array.
+         * @param element The element to append.
+         */
+        void push_back(value_type const& element);
+
+        /**
+         * Appends an element to the array.
+         * @param element The element to append.
+         */
+        void push_back(value_type&& element);
+
+        /**
+         * Constructs an element in place at the end of the array.
+         * @tparam Args The types of the constructor arguments.
+         * @param args The constructor arguments.
+         */
+        template <typename... Args>
+        void emplace_back(Args&&... args)
+        {
+            mutate().emplace_back(std::forward<Args>(args)...);
+        }
+
+        /**
+         * Removes the last element of the array.
+         */
+        void pop_back();
+
+        /**
+         * Inserts an element into the array.
+         * @param position The position to insert at; must be an iterator of this array.
+         * @param element The element to insert.
+         * @return Returns an iterator to the inserted element.
+         */
+        iterator insert(const_iterator position, value_type element);
+
+        /**
+         * Inserts a range of elements into the array.
+         * @tparam InputIterator The input iterator type.
+         * @param position The position to insert at; must be an iterator of this array.
+         * @param first The beginning of the range to insert.
+         * @param last The end of the range to insert.
+         * @return Returns an iterator to the first inserted element.
+         */
+        template <typename InputIterator>
+        iterator insert(const_iterator position, InputIterator first, InputIterator last)
+        {
+            // Rebase the position as the elements may be copied if they are shared
+            auto offset = position - elements().begin();
+            auto& sequence = mutate();
+            return sequence.insert(sequence.begin() + offset, first, last);
+        }
+
+        /**
+         * Erases an element from the array.
+         * @param position The position of the element to erase; must be an iterator of this array.
+         * @return Returns an iterator following the erased element.
+         */
+        iterator erase(const_iterator position);
+
+        /**
+         * Erases a range of elements from the array.
+         * @param first The beginning of the range to erase; must be an iterator of this array.
+         * @param last The end of the range to erase; must be an iterator of this array.
+         * @return Returns an iterator following the last erased element.
+         */
+        iterator erase(const_iterator first, const_iterator last);
+
+        /**
+         * Swaps the elements of this array with another.
+         * @param other The other array to swap with.
+         */
+        void swap(array& other) noexcept;
 
         /**
          * Joins the array by converting each element to a string.
          * @param os The output stream to write to.
          * @param separator The separator to write between array elements.
          */
-        void join(std::ostream& os, std::string const& separator = " ");
+        void join(std::ostream& os, std::string const& separator = " ") const;
+
+     private:
+        sequence_type const& elements() const
+        {
+            return _elements ? *_elements : _empty;
+        }
+
+        sequence_type& mutate();
+
+        static sequence_type const _empty;
+        std::shared_ptr<sequence_type> _elements;
     };
 
     /**
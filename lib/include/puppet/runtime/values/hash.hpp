@@ -4,62 +4,36 @@
  */
 #pragma once
 
-#include "wrapper.hpp"
+#include "forward.hpp"
 #include <boost/functional/hash.hpp>
 #include <ostream>
 #include <functional>
-#include <list>
-#include <unordered_map>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace puppet { namespace runtime { namespace values {
 
     /**
      * Represents a runtime hash value.
      * This models a Ruby hash in that it maintains insertion order but provides an O(1) lookup.
+     * The pairs are kept in a dense vector in insertion order with an open-addressed index of positions into it.
+     * The elements are shared between copies of the hash and only copied when a copy is modified (copy-on-write).
+     * Note: any member that returns a non-const iterator or pointer is a modification as it may be used to modify the hash.
      */
     struct hash
     {
         /**
          * Represents a hash pair.
+         * The pair is defined with the runtime value as it stores the key and value inline.
          */
-        struct pair
-        {
-            /**
-             * Constructs a hash pair.
-             * @param key The element key.
-             * @param value The element value.
-             */
-            pair(values::value key, values::value value);
-
-            /**
-             * Gets the key of the hash pair.
-             * @return Returns the key of the hash pair.
-             */
-            values::value const& key() const;
-
-            /**
-             * Gets the value of the hash pair.
-             * @return Returns the value of the hash pair.
-             */
-            values::value& value();
-
-            /**
-             * Gets the value of the hash pair.
-             * @return Returns the value of the hash pair.
-             */
-            values::value const& value() const;
-
-         private:
-            wrapper<values::value> _key;
-            wrapper<values::value> _value;
-        };
+        struct pair;
 
         /**
          * The underlying sequence type.
-         * This is a list because the index keeps list references and they cannot be invalidated unless erased.
-         * This also provides for a faster erase implementation.
+         * The pairs are stored contiguously in insertion order; the index refers to pairs by position.
          */
-        using sequence_type = std::list<pair>;
+        using sequence_type = std::vector<pair>;
 
         /**
          * The iterator type for hash.
@@ -88,9 +62,9 @@ namespace puppet { namespace runtime { namespace values {
 
         /**
          * Copy constructor for hash.
-         * @param other The other hash to copy.
+         * The elements are shared with the other hash.
          */
-        hash(hash const& other);
+        hash(hash const&) = default;
 
         /**
          * Move constructor for hash.
@@ -99,10 +73,10 @@ namespace puppet { namespace runtime { namespace values {
 
         /**
          * Copy assignment operator for hash.
-         * @param other The other hash to copy.
+         * The elements are shared with the other hash.
          * @return Returns this hash.
          */
-        hash& operator=(hash const& other);
+        hash& operator=(hash const&) = default;
 
         /**
          * Move assignment operator for hash.
@@ -223,6 +197,22 @@ namespace puppet { namespace runtime { namespace values {
          */
         value const* get(value const& key) const;
 
+        /**
+         * Gets a value from the hash given a string key.
+         * This avoids constructing a runtime value for the key.
+         * @param key The key of the element to get the value for.
+         * @return Returns a pointer to the value if the key is in the hash or nullptr if the key is not in the hash.
+         */
+        value* get(std::string const& key);
+
+        /**
+         * Gets a value from the hash given a string key.
+         * This avoids constructing a runtime value for the key.
+         * @param key The key of the element to get the value for.
+         * @return Returns a pointer to the value if the key is in the hash or nullptr if the key is not in the hash.
+         */
+        value const* get(std::string const& key) const;
+
         /**
          * Erases an element from the hash.
          * @param key The key to erase.
@@ -231,18 +221,13 @@ namespace puppet { namespace runtime { namespace values {
         bool erase(value const& key);
 
      private:
-        struct indirect_hasher
-        {
-            size_t operator()(values::value const* value) const;
-        };
-
-        struct indirect_comparer
-        {
-            bool operator()(values::value const* right, values::value const* left) const;
-        };
-
-        sequence_type _elements;
-        std::unordered_map<value const*, iterator, indirect_hasher, indirect_comparer> _index;
+        struct storage;
+
+        storage const& elements() const;
+        storage& mutate();
+
+        static storage const _empty;
+        std::shared_ptr<storage> _storage;
     };
 
     /**
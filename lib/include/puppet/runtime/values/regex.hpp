@@ -7,11 +7,14 @@
 #include <regex>
 #include <string>
 #include <ostream>
+#include <memory>
 
 namespace puppet { namespace runtime { namespace values {
 
     /**
      * Represents a runtime regex.
+     * The pattern and compiled regex are shared between copies so that a regex value is pointer-sized.
+     * Compiled regexes are kept in a process-wide cache keyed by pattern, so constructing a regex with a recently used pattern does not recompile it.
      */
     struct regex
     {
@@ -22,6 +25,7 @@ namespace puppet { namespace runtime { namespace values {
 
         /**
          * Constructs a regex with the given pattern.
+         * Throws std::regex_error if the pattern is not a valid regular expression.
          * @param pattern The pattern for the regex.
          */
         explicit regex(std::string pattern);
@@ -39,8 +43,15 @@ namespace puppet { namespace runtime { namespace values {
         std::regex const& value() const;
 
     private:
-        std::string _pattern;
-        std::regex _regex;
+        struct compiled
+        {
+            std::string pattern;
+            std::regex value;
+        };
+
+        static std::shared_ptr<compiled const> compile(std::string pattern);
+
+        std::shared_ptr<compiled const> _compiled;
     };
 
     /**
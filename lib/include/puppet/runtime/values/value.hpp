@@ -14,6 +14,7 @@
 #include "type.hpp"
 #include "undef.hpp"
 #include "variable.hpp"
+#include "wrapper.hpp"
 #include "../../cast.hpp"
 #include <boost/variant.hpp>
 #include <boost/mpl/contains.hpp>
@@ -21,31 +22,18 @@
 #include <cstddef>
 #include <functional>
 
-// Forward declare needed RapidJSON types.
-namespace rapidjson {
-    class CrtAllocator;
-    template <typename Encoding, typename Allocator> class GenericValue;
-    template <typename Encoding, typename Allocator, typename StackAllocator> class GenericDocument;
-    template<typename CharType> struct UTF8;
-}
+namespace puppet { namespace runtime {
 
-namespace puppet { namespace runtime { namespace values {
+    // Forward declaration of the data writer.
+    struct data_writer;
 
-    /**
-     * The RapidJSON allocator.
-     */
-    using json_allocator = rapidjson::CrtAllocator;
-    /**
-     * The RapidJSON value.
-     */
-    using json_value = rapidjson::GenericValue<rapidjson::UTF8<char>, json_allocator>;
-    /**
-     * The RapidJSON document.
-     */
-    using json_document = rapidjson::GenericDocument<rapidjson::UTF8<char>, json_allocator, json_allocator>;
+}}  // namespace puppet::runtime
+
+namespace puppet { namespace runtime { namespace values {
 
     /**
      * Represents all possible value types.
+     * Types are boxed as they are much larger than the other alternatives and would otherwise dominate the size of every value.
      */
     using value_base = boost::variant<
         undef,
@@ -55,7 +43,7 @@ namespace puppet { namespace runtime { namespace values {
         bool,
         std::string,
         regex,
-        type,
+        boost::recursive_wrapper<type>,
         variable,
         array,
         hash
@@ -85,7 +73,7 @@ namespace puppet { namespace runtime { namespace values {
             >::type
         >
         value(T const& value) :
-            value_base(value)
+            value_base(static_cast<boxed_t<T, T const&>>(value))
         {
         }
 
@@ -105,7 +93,7 @@ namespace puppet { namespace runtime { namespace values {
             >::type
         >
         value(T&& value) noexcept :
-            value_base(rvalue_cast(value))
+            value_base(static_cast<boxed_t<T, T&&>>(rvalue_cast(value)))
         {
         }
 
@@ -156,7 +144,7 @@ namespace puppet { namespace runtime { namespace values {
         >
         value& operator=(T const& value)
         {
-            value_base::operator=(value);
+            value_base::operator=(static_cast<boxed_t<T, T const&>>(value));
             return *this;
         }
 
@@ -178,7 +166,7 @@ namespace puppet { namespace runtime { namespace values {
         >
         value& operator=(T&& value)
         {
-            value_base::operator=(rvalue_cast(value));
+            value_base::operator=(static_cast<boxed_t<T, T&&>>(rvalue_cast(value)));
             return *this;
         }
 
@@ -231,7 +219,7 @@ namespace puppet { namespace runtime { namespace values {
                 // For arrays, recurse on each element
                 auto array = move_as<values::array>();
                 for (auto& element : array) {
-                    if (!element->move_as<T>(callback)) {
+                    if (!element.move_as<T>(callback)) {
                         return false;
                     }
                 }
@@ -293,11 +281,10 @@ namespace puppet { namespace runtime { namespace values {
         void each_resource(std::function<void(runtime::types::resource const&)> const& callback, std::function<void(std::string const&)> const& error) const;
 
         /**
-         * Creates a RapidJSON value for the value.
-         * @param allocator The current RapidJSON allocator.
-         * @return Returns the runtime value as a RapidJSON value.
+         * Writes the value to a data writer (e.g. as JSON).
+         * @param writer The data writer to write to.
          */
-        json_value to_json(json_allocator& allocator) const;
+        void write(data_writer& writer) const;
 
         /**
          * Called to apply a visitor to the value.
@@ -314,6 +301,15 @@ namespace puppet { namespace runtime { namespace values {
             }
             return value_base::apply_visitor(visitor);
         }
+
+     private:
+        // Runtime types (e.g. Integer) are converted to a type value first as the type value is boxed in the variant
+        template <typename T, typename Otherwise>
+        using boxed_t = typename std::conditional<
+            boost::mpl::contains<typename type_variant::types, typename std::decay<T>::type>::value,
+            values::type,
+            Otherwise
+        >::type;
     };
 
     /**
@@ -416,6 +412,91 @@ namespace puppet { namespace runtime { namespace values {
         return boost::apply_visitor(std::bind(equality_visitor(), std::placeholders::_1, std::ref(right)), left);
     }
 
+    /**
+     * Represents a hash pair.
+     */
+    struct hash::pair
+    {
+        /**
+         * Constructs a hash pair.
+         * @param key The element key.
+         * @param value The element value.
+         */
+        pair(values::value key, values::value value) :
+            _key(rvalue_cast(key)),
+            _value(rvalue_cast(value))
+        {
+        }
+
+        /**
+         * Gets the key of the hash pair.
+         * @return Returns the key of the hash pair.
+         */
+        values::value const& key() const
+        {
+            return _key;
+        }
+
+        /**
+         * Gets the value of the hash pair.
+         * @return Returns the value of the hash pair.
+         */
+        values::value& value()
+        {
+            return _value;
+        }
+
+        /**
+         * Gets the value of the hash pair.
+         * @return Returns the value of the hash pair.
+         */
+        values::value const& value() const
+        {
+            return _value;
+        }
+
+     private:
+        values::value _key;
+        values::value _value;
+    };
+
+    // The following array members are defined here as they require the complete value type
+
+    inline array::size_type array::size() const
+    {
+        return _elements ? _elements->size() : 0;
+    }
+
+    inline array::reference array::operator[](size_type index)
+    {
+        return mutate()[index];
+    }
+
+    inline array::const_reference array::operator[](size_type index) const
+    {
+        return elements()[index];
+    }
+
+    inline array::reference array::at(size_type index)
+    {
+        return mutate().at(index);
+    }
+
+    inline array::const_reference array::at(size_type index) const
+    {
+        return elements().at(index);
+    }
+
+    inline array::reference array::back()
+    {
+        return mutate().back();
+    }
+
+    inline array::const_reference array::back() const
+    {
+        return elements().back();
+    }
+
     /**
      * Enumerates each Unicode code point in the given string.
      * @param str The string to enumerate.
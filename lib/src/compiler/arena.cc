@@ -0,0 +1,43 @@
+#include <puppet/compiler/arena.hpp>
+#include <cstdint>
+
+using namespace std;
+
+namespace puppet { namespace compiler {
+
+    arena::arena(size_t block_size) :
+        _current(nullptr),
+        _remaining(0),
+        _block_size(block_size),
+        _allocated(0)
+    {
+    }
+
+    void* arena::allocate(size_t size, size_t alignment)
+    {
+        auto padding = (alignment - reinterpret_cast<uintptr_t>(_current) % alignment) % alignment;
+        if (!_current || padding + size > _remaining) {
+            // Allocate a new block large enough for the request; operator new[] aligns for any fundamental type
+            while (_block_size < size + alignment) {
+                _block_size *= 2;
+            }
+            _blocks.emplace_back(new char[_block_size]);
+            _current = _blocks.back().get();
+            _remaining = _block_size;
+            _block_size *= 2;
+            padding = (alignment - reinterpret_cast<uintptr_t>(_current) % alignment) % alignment;
+        }
+
+        auto memory = _current + padding;
+        _current += padding + size;
+        _remaining -= padding + size;
+        _allocated += size;
+        return memory;
+    }
+
+    size_t arena::allocated() const
+    {
+        return _allocated;
+    }
+
+}}  // namespace puppet::compiler
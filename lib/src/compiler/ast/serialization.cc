@@ -0,0 +1,984 @@
+#include <puppet/compiler/ast/serialization.hpp>
+#include <puppet/cast.hpp>
+#include <cstring>
+
+using namespace std;
+namespace x3 = boost::spirit::x3;
+
+namespace puppet { namespace compiler { namespace ast {
+
+    // Unsigned integers are written as LEB128 variable-length integers; signed integers are zig-zag encoded first
+    struct writer : boost::static_visitor<>
+    {
+        explicit writer(ostream& out) :
+            _out(out)
+        {
+        }
+
+        void write_unsigned(uint64_t value) const
+        {
+            char buffer[10];
+            size_t size = 0;
+            do {
+                auto byte = static_cast<uint8_t>(value & 0x7F);
+                value >>= 7;
+                if (value) {
+                    byte |= 0x80;
+                }
+                buffer[size++] = static_cast<char>(byte);
+            } while (value);
+            _out.write(buffer, size);
+        }
+
+        void write_signed(int64_t value) const
+        {
+            write_unsigned((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        void write_bool(bool value) const
+        {
+            _out.put(value ? 1 : 0);
+        }
+
+        void write_string(std::string const& value) const
+        {
+            write_unsigned(value.size());
+            _out.write(value.data(), value.size());
+        }
+
+        void write(lexer::position const& position) const
+        {
+            write_unsigned(position.offset());
+            write_unsigned(position.line());
+        }
+
+        void write(ast::context const& context) const
+        {
+            write(context.position);
+        }
+
+        template <typename T>
+        void write(vector<T> const& elements) const
+        {
+            write_unsigned(elements.size());
+            for (auto const& element : elements) {
+                write(element);
+            }
+        }
+
+        template <typename T>
+        void write(boost::optional<T> const& value) const
+        {
+            write_bool(static_cast<bool>(value));
+            if (value) {
+                write(*value);
+            }
+        }
+
+        template <typename T>
+        void write(x3::forward_ast<T> const& node) const
+        {
+            write(node.get());
+        }
+
+        template <typename T>
+        void operator()(T const& node) const
+        {
+            write(node);
+        }
+
+        template <typename Variant>
+        void write_variant(Variant const& node) const
+        {
+            write_unsigned(node.get().which());
+            boost::apply_visitor(*this, node);
+        }
+
+        void write(undef const& node) const
+        {
+            write(node.context);
+        }
+
+        void write(defaulted const& node) const
+        {
+            write(node.context);
+        }
+
+        void write(boolean const& node) const
+        {
+            write(node.context);
+            write_bool(node.value);
+        }
+
+        void write(number const& node) const
+        {
+            write(node.context);
+            write_unsigned(node.value.which());
+            if (auto integer = boost::get<int64_t>(&node.value)) {
+                write_signed(*integer);
+            } else {
+                auto floating = boost::get<long double>(node.value);
+                char buffer[sizeof(long double)] = {};
+                memcpy(buffer, &floating, sizeof(buffer));
+                _out.write(buffer, sizeof(buffer));
+            }
+        }
+
+        void write(ast::string const& node) const
+        {
+            write(node.context);
+            write_string(node.value);
+            write_string(node.escapes);
+            _out.put(node.quote);
+            write_bool(node.interpolated);
+            write_string(node.format);
+            write_signed(node.margin);
+            write_bool(node.remove_break);
+        }
+
+        void write(regex const& node) const
+        {
+            write(node.context);
+            write_string(node.value);
+        }
+
+        void write(variable const& node) const
+        {
+            write(node.context);
+            write_string(node.name);
+        }
+
+        void write(name const& node) const
+        {
+            write(node.context);
+            write_string(node.value);
+        }
+
+        void write(bare_word const& node) const
+        {
+            write(node.context);
+            write_string(node.value);
+        }
+
+        void write(type const& node) const
+        {
+            write(node.context);
+            write_string(node.name);
+        }
+
+        void write(primary_expression const& node) const
+        {
+            write_variant(node);
+        }
+
+        void write(postfix_subexpression const& node) const
+        {
+            write_variant(node);
+        }
+
+        void write(postfix_expression const& node) const
+        {
+            write(node.primary);
+            write(node.subexpressions);
+        }
+
+        void write(binary_expression const& node) const
+        {
+            write(node.context);
+            write_unsigned(static_cast<uint64_t>(node.oper));
+            write(node.operand);
+        }
+
+        void write(expression const& node) const
+        {
+            write(node.postfix);
+            write(node.remainder);
+        }
+
+        void write(array const& node) const
+        {
+            write(node.context);
+            write(node.elements);
+        }
+
+        void write(ast::pair const& node) const
+        {
+            write(node.first);
+            write(node.second);
+        }
+
+        void write(hash const& node) const
+        {
+            write(node.context);
+            write(node.elements);
+        }
+
+        void write(selector_expression const& node) const
+        {
+            write(node.context);
+            write(node.cases);
+        }
+
+        void write(case_proposition const& node) const
+        {
+            write(node.options);
+            write(node.body);
+        }
+
+        void write(case_expression const& node) const
+        {
+            write(node.context);
+            write(node.conditional);
+            write(node.propositions);
+        }
+
+        void write(else_expression const& node) const
+        {
+            write(node.context);
+            write(node.body);
+        }
+
+        void write(elsif_expression const& node) const
+        {
+            write(node.context);
+            write(node.conditional);
+            write(node.body);
+        }
+
+        void write(if_expression const& node) const
+        {
+            write(node.context);
+            write(node.conditional);
+            write(node.body);
+            write(node.elsifs);
+            write(node.else_);
+        }
+
+        void write(unless_expression const& node) const
+        {
+            write(node.context);
+            write(node.conditional);
+            write(node.body);
+            write(node.else_);
+        }
+
+        void write(access_expression const& node) const
+        {
+            write(node.context);
+            write(node.arguments);
+        }
+
+        void write(parameter const& node) const
+        {
+            write(node.type);
+            write_bool(node.captures);
+            write(node.variable);
+            write(node.default_value);
+        }
+
+        void write(lambda_expression const& node) const
+        {
+            write(node.context);
+            write(node.parameters);
+            write(node.body);
+        }
+
+        void write(method_call_expression const& node) const
+        {
+            write(node.context);
+            write(node.method);
+            write(node.arguments);
+            write(node.lambda);
+        }
+
+        void write(function_call_expression const& node) const
+        {
+            write(node.function);
+            write(node.arguments);
+            write(node.lambda);
+        }
+
+        void write(attribute const& node) const
+        {
+            write(node.name);
+            write_unsigned(static_cast<uint64_t>(node.oper));
+            write(node.value);
+        }
+
+        void write(resource_body const& node) const
+        {
+            write(node.title);
+            write(node.attributes);
+        }
+
+        void write(resource_expression const& node) const
+        {
+            write_unsigned(static_cast<uint64_t>(node.status));
+            write(node.type);
+            write(node.bodies);
+        }
+
+        void write(resource_override_expression const& node) const
+        {
+            write(node.reference);
+            write(node.attributes);
+        }
+
+        void write(resource_defaults_expression const& node) const
+        {
+            write(node.type);
+            write(node.attributes);
+        }
+
+        void write(class_expression const& node) const
+        {
+            write(node.context);
+            write(node.name);
+            write(node.parameters);
+            write(node.parent);
+            write(node.body);
+        }
+
+        void write(defined_type_expression const& node) const
+        {
+            write(node.context);
+            write(node.name);
+            write(node.parameters);
+            write(node.body);
+        }
+
+        void write(boost::variant<name, bare_word, number> const& node) const
+        {
+            write_unsigned(node.which());
+            boost::apply_visitor(*this, node);
+        }
+
+        void write(hostname const& node) const
+        {
+            write_variant(node);
+        }
+
+        void write(node_expression const& node) const
+        {
+            write(node.context);
+            write(node.hostnames);
+            write(node.body);
+        }
+
+        void write(attribute_query const& node) const
+        {
+            write(node.attribute);
+            write_unsigned(static_cast<uint64_t>(node.oper));
+            write(node.value);
+        }
+
+        void write(attribute_query_expression const& node) const
+        {
+            write_variant(node);
+        }
+
+        void write(binary_attribute_query const& node) const
+        {
+            write(node.context);
+            write_unsigned(static_cast<uint64_t>(node.oper));
+            write(node.operand);
+        }
+
+        void write(collector_query_expression const& node) const
+        {
+            write(node.primary);
+            write(node.remainder);
+        }
+
+        void write(collector_expression const& node) const
+        {
+            write(node.type);
+            write_bool(node.exported);
+            write(node.query);
+        }
+
+        void write(unary_expression const& node) const
+        {
+            write(node.context);
+            write_unsigned(static_cast<uint64_t>(node.oper));
+            write(node.operand);
+        }
+
+        void write(epp_render_expression const& node) const
+        {
+            write(node.context);
+            write(node.expression);
+        }
+
+        void write(epp_render_block const& node) const
+        {
+            write(node.context);
+            write(node.block);
+        }
+
+        void write(epp_render_string const& node) const
+        {
+            write(node.context);
+            write_string(node.string);
+        }
+
+        void write(syntax_tree const& tree) const
+        {
+            write(tree.parameters);
+            write(tree.statements);
+            write(tree.closing_position);
+        }
+
+     private:
+        ostream& _out;
+    };
+
+    // Thrown when the serialized data is truncated or malformed
+    struct invalid_data {};
+
+    struct reader
+    {
+        reader(char const* data, size_t size, syntax_tree& tree) :
+            _current(data),
+            _end(data + size),
+            _tree(tree)
+        {
+        }
+
+        bool at_end() const
+        {
+            return _current == _end;
+        }
+
+        uint64_t read_unsigned()
+        {
+            uint64_t value = 0;
+            for (unsigned int shift = 0; shift < 64; shift += 7) {
+                auto byte = static_cast<uint8_t>(read_byte());
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) {
+                    return value;
+                }
+            }
+            throw invalid_data();
+        }
+
+        int64_t read_signed()
+        {
+            auto value = read_unsigned();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        bool read_bool()
+        {
+            return read_byte() != 0;
+        }
+
+        std::string read_string()
+        {
+            auto size = read_size();
+            std::string value{ _current, _current + size };
+            _current += size;
+            return value;
+        }
+
+        template <typename Enum>
+        Enum read_enum(Enum last)
+        {
+            auto value = read_unsigned();
+            if (value > static_cast<uint64_t>(last)) {
+                throw invalid_data();
+            }
+            return static_cast<Enum>(value);
+        }
+
+        void read(lexer::position& position)
+        {
+            auto offset = read_unsigned();
+            auto line = read_unsigned();
+            position = lexer::position{ static_cast<size_t>(offset), static_cast<size_t>(line) };
+        }
+
+        void read(ast::context& context)
+        {
+            context.tree = &_tree;
+            read(context.position);
+        }
+
+        template <typename T>
+        void read(vector<T>& elements)
+        {
+            auto size = read_size();
+            elements.clear();
+            elements.reserve(size);
+            for (size_t i = 0; i < size; ++i) {
+                elements.emplace_back();
+                read(elements.back());
+            }
+        }
+
+        template <typename T>
+        void read(boost::optional<T>& value)
+        {
+            if (!read_bool()) {
+                value = boost::none;
+                return;
+            }
+            value = T();
+            read(*value);
+        }
+
+        template <typename T>
+        void read(x3::forward_ast<T>& node)
+        {
+            read(node.get());
+        }
+
+        template <typename T, typename Variant>
+        void read_alternative(Variant& node)
+        {
+            T value;
+            read(value);
+            node = rvalue_cast(value);
+        }
+
+        void read(undef& node)
+        {
+            read(node.context);
+        }
+
+        void read(defaulted& node)
+        {
+            read(node.context);
+        }
+
+        void read(boolean& node)
+        {
+            read(node.context);
+            node.value = read_bool();
+        }
+
+        void read(number& node)
+        {
+            read(node.context);
+            switch (read_unsigned()) {
+                case 0:
+                    node.value = read_signed();
+                    break;
+
+                case 1: {
+                    if (static_cast<size_t>(_end - _current) < sizeof(long double)) {
+                        throw invalid_data();
+                    }
+                    long double value;
+                    memcpy(&value, _current, sizeof(value));
+                    _current += sizeof(value);
+                    node.value = value;
+                    break;
+                }
+
+                default:
+                    throw invalid_data();
+            }
+        }
+
+        void read(ast::string& node)
+        {
+            read(node.context);
+            node.value = read_string();
+            node.escapes = read_string();
+            node.quote = read_byte();
+            node.interpolated = read_bool();
+            node.format = read_string();
+            node.margin = static_cast<int>(read_signed());
+            node.remove_break = read_bool();
+        }
+
+        void read(regex& node)
+        {
+            read(node.context);
+            node.value = read_string();
+        }
+
+        void read(variable& node)
+        {
+            read(node.context);
+            node.name = read_string();
+        }
+
+        void read(name& node)
+        {
+            read(node.context);
+            node.value = read_string();
+        }
+
+        void read(bare_word& node)
+        {
+            read(node.context);
+            node.value = read_string();
+        }
+
+        void read(type& node)
+        {
+            read(node.context);
+            node.name = read_string();
+        }
+
+        void read(primary_expression& node)
+        {
+            // The alternatives are read in the order they are declared in the variant
+            switch (read_unsigned()) {
+                case 0:  read_alternative<undef>(node); break;
+                case 1:  read_alternative<defaulted>(node); break;
+                case 2:  read_alternative<boolean>(node); break;
+                case 3:  read_alternative<number>(node); break;
+                case 4:  read_alternative<ast::string>(node); break;
+                case 5:  read_alternative<regex>(node); break;
+                case 6:  read_alternative<variable>(node); break;
+                case 7:  read_alternative<name>(node); break;
+                case 8:  read_alternative<bare_word>(node); break;
+                case 9:  read_alternative<type>(node); break;
+                case 10: read_alternative<x3::forward_ast<expression>>(node); break;
+                case 11: read_alternative<x3::forward_ast<array>>(node); break;
+                case 12: read_alternative<x3::forward_ast<hash>>(node); break;
+                case 13: read_alternative<x3::forward_ast<case_expression>>(node); break;
+                case 14: read_alternative<x3::forward_ast<if_expression>>(node); break;
+                case 15: read_alternative<x3::forward_ast<unless_expression>>(node); break;
+                case 16: read_alternative<x3::forward_ast<function_call_expression>>(node); break;
+                case 17: read_alternative<x3::forward_ast<resource_expression>>(node); break;
+                case 18: read_alternative<x3::forward_ast<resource_override_expression>>(node); break;
+                case 19: read_alternative<x3::forward_ast<resource_defaults_expression>>(node); break;
+                case 20: read_alternative<x3::forward_ast<class_expression>>(node); break;
+                case 21: read_alternative<x3::forward_ast<defined_type_expression>>(node); break;
+                case 22: read_alternative<x3::forward_ast<node_expression>>(node); break;
+                case 23: read_alternative<x3::forward_ast<collector_expression>>(node); break;
+                case 24: read_alternative<x3::forward_ast<unary_expression>>(node); break;
+                case 25: read_alternative<x3::forward_ast<epp_render_expression>>(node); break;
+                case 26: read_alternative<x3::forward_ast<epp_render_block>>(node); break;
+                case 27: read_alternative<x3::forward_ast<epp_render_string>>(node); break;
+                default: throw invalid_data();
+            }
+        }
+
+        void read(postfix_subexpression& node)
+        {
+            switch (read_unsigned()) {
+                case 0: read_alternative<x3::forward_ast<selector_expression>>(node); break;
+                case 1: read_alternative<x3::forward_ast<access_expression>>(node); break;
+                case 2: read_alternative<x3::forward_ast<method_call_expression>>(node); break;
+                default: throw invalid_data();
+            }
+        }
+
+        void read(postfix_expression& node)
+        {
+            read(node.primary);
+            read(node.subexpressions);
+        }
+
+        void read(binary_expression& node)
+        {
+            read(node.context);
+            node.oper = read_enum(binary_operator::out_edge_subscribe);
+            read(node.operand);
+        }
+
+        void read(expression& node)
+        {
+            read(node.postfix);
+            read(node.remainder);
+        }
+
+        void read(array& node)
+        {
+            read(node.context);
+            read(node.elements);
+        }
+
+        void read(ast::pair& node)
+        {
+            read(node.first);
+            read(node.second);
+        }
+
+        void read(hash& node)
+        {
+            read(node.context);
+            read(node.elements);
+        }
+
+        void read(selector_expression& node)
+        {
+            read(node.context);
+            read(node.cases);
+        }
+
+        void read(case_proposition& node)
+        {
+            read(node.options);
+            read(node.body);
+        }
+
+        void read(case_expression& node)
+        {
+            read(node.context);
+            read(node.conditional);
+            read(node.propositions);
+        }
+
+        void read(else_expression& node)
+        {
+            read(node.context);
+            read(node.body);
+        }
+
+        void read(elsif_expression& node)
+        {
+            read(node.context);
+            read(node.conditional);
+            read(node.body);
+        }
+
+        void read(if_expression& node)
+        {
+            read(node.context);
+            read(node.conditional);
+            read(node.body);
+            read(node.elsifs);
+            read(node.else_);
+        }
+
+        void read(unless_expression& node)
+        {
+            read(node.context);
+            read(node.conditional);
+            read(node.body);
+            read(node.else_);
+        }
+
+        void read(access_expression& node)
+        {
+            read(node.context);
+            read(node.arguments);
+        }
+
+        void read(parameter& node)
+        {
+            read(node.type);
+            node.captures = read_bool();
+            read(node.variable);
+            read(node.default_value);
+        }
+
+        void read(lambda_expression& node)
+        {
+            read(node.context);
+            read(node.parameters);
+            read(node.body);
+        }
+
+        void read(method_call_expression& node)
+        {
+            read(node.context);
+            read(node.method);
+            read(node.arguments);
+            read(node.lambda);
+        }
+
+        void read(function_call_expression& node)
+        {
+            read(node.function);
+            read(node.arguments);
+            read(node.lambda);
+        }
+
+        void read(attribute& node)
+        {
+            read(node.name);
+            node.oper = read_enum(attribute_operator::append);
+            read(node.value);
+        }
+
+        void read(resource_body& node)
+        {
+            read(node.title);
+            read(node.attributes);
+        }
+
+        void read(resource_expression& node)
+        {
+            node.status = read_enum(resource_status::exported);
+            read(node.type);
+            read(node.bodies);
+        }
+
+        void read(resource_override_expression& node)
+        {
+            read(node.reference);
+            read(node.attributes);
+        }
+
+        void read(resource_defaults_expression& node)
+        {
+            read(node.type);
+            read(node.attributes);
+        }
+
+        void read(class_expression& node)
+        {
+            read(node.context);
+            read(node.name);
+            read(node.parameters);
+            read(node.parent);
+            read(node.body);
+        }
+
+        void read(defined_type_expression& node)
+        {
+            read(node.context);
+            read(node.name);
+            read(node.parameters);
+            read(node.body);
+        }
+
+        void read(boost::variant<name, bare_word, number>& node)
+        {
+            switch (read_unsigned()) {
+                case 0: read_alternative<name>(node); break;
+                case 1: read_alternative<bare_word>(node); break;
+                case 2: read_alternative<number>(node); break;
+                default: throw invalid_data();
+            }
+        }
+
+        void read(hostname& node)
+        {
+            switch (read_unsigned()) {
+                case 0: read_alternative<defaulted>(node); break;
+                case 1: read_alternative<ast::string>(node); break;
+                case 2: read_alternative<regex>(node); break;
+                case 3: read_alternative<hostname_parts>(node); break;
+                default: throw invalid_data();
+            }
+        }
+
+        void read(node_expression& node)
+        {
+            read(node.context);
+            read(node.hostnames);
+            read(node.body);
+        }
+
+        void read(attribute_query& node)
+        {
+            read(node.attribute);
+            node.oper = read_enum(attribute_query_operator::not_equals);
+            read(node.value);
+        }
+
+        void read(attribute_query_expression& node)
+        {
+            switch (read_unsigned()) {
+                case 0: read_alternative<attribute_query>(node); break;
+                case 1: read_alternative<x3::forward_ast<collector_query_expression>>(node); break;
+                default: throw invalid_data();
+            }
+        }
+
+        void read(binary_attribute_query& node)
+        {
+            read(node.context);
+            node.oper = read_enum(binary_query_operator::logical_or);
+            read(node.operand);
+        }
+
+        void read(collector_query_expression& node)
+        {
+            read(node.primary);
+            read(node.remainder);
+        }
+
+        void read(collector_expression& node)
+        {
+            read(node.type);
+            node.exported = read_bool();
+            read(node.query);
+        }
+
+        void read(unary_expression& node)
+        {
+            read(node.context);
+            node.oper = read_enum(unary_operator::splat);
+            read(node.operand);
+        }
+
+        void read(epp_render_expression& node)
+        {
+            read(node.context);
+            read(node.expression);
+        }
+
+        void read(epp_render_block& node)
+        {
+            read(node.context);
+            read(node.block);
+        }
+
+        void read(epp_render_string& node)
+        {
+            read(node.context);
+            node.string = read_string();
+        }
+
+        void read()
+        {
+            read(_tree.parameters);
+            read(_tree.statements);
+            read(_tree.closing_position);
+        }
+
+     private:
+        char read_byte()
+        {
+            if (_current == _end) {
+                throw invalid_data();
+            }
+            return *_current++;
+        }
+
+        size_t read_size()
+        {
+            // Every element takes at least one byte, so a larger size can only come from malformed data
+            auto size = read_unsigned();
+            if (size > static_cast<uint64_t>(_end - _current)) {
+                throw invalid_data();
+            }
+            return static_cast<size_t>(size);
+        }
+
+        char const* _current;
+        char const* _end;
+        syntax_tree& _tree;
+    };
+
+    void serialize(ostream& out, syntax_tree const& tree)
+    {
+        writer{ out }.write(tree);
+    }
+
+    shared_ptr<syntax_tree> deserialize(char const* data, size_t size, std::string path, compiler::module const* module)
+    {
+        auto tree = syntax_tree::create(rvalue_cast(path), module);
+        try {
+            reader reader{ data, size, *tree };
+            reader.read();
+            if (!reader.at_end()) {
+                return nullptr;
+            }
+        } catch (invalid_data const&) {
+            return nullptr;
+        }
+        return tree;
+    }
+
+}}}  // namespace puppet::compiler::ast
@@ -0,0 +1,179 @@
+#include <puppet/compiler/ast_cache.hpp>
+#include <puppet/compiler/ast/serialization.hpp>
+#include <puppet/compiler/parser/parser.hpp>
+#include <puppet/compiler/exceptions.hpp>
+#include <puppet/cast.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+namespace fs = boost::filesystem;
+namespace sys = boost::system;
+
+namespace puppet { namespace compiler {
+
+    // The magic identifies the layout of the cache file; the serialized AST is identified by its format version
+    static char const cache_magic[] = { 'P', 'P', 'A', 'S', 'T', 0, 0, 2 };
+
+    static string const& cache_version()
+    {
+        static const string version = LIBPUPPET_VERSION;
+        return version;
+    }
+
+    static bool read_file(string const& path, string& contents)
+    {
+        // Read into memory rather than mapping so that a file replaced while being read cannot fault the process
+        ifstream input{ path, ios::binary };
+        if (!input) {
+            return false;
+        }
+        contents.assign(istreambuf_iterator<char>(input), istreambuf_iterator<char>());
+        return !input.bad();
+    }
+
+    static uint64_t hash_bytes(char const* data, size_t size)
+    {
+        // 64-bit FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    static void write_header(ostream& out, string const& path, uint64_t hash, uint64_t size)
+    {
+        auto const& version = cache_version();
+        uint32_t version_size = static_cast<uint32_t>(version.size());
+        uint32_t path_size = static_cast<uint32_t>(path.size());
+
+        out.write(cache_magic, sizeof(cache_magic));
+        out.write(reinterpret_cast<char const*>(&ast::format_version), sizeof(ast::format_version));
+        out.write(reinterpret_cast<char const*>(&hash), sizeof(hash));
+        out.write(reinterpret_cast<char const*>(&size), sizeof(size));
+        out.write(reinterpret_cast<char const*>(&version_size), sizeof(version_size));
+        out.write(version.data(), version_size);
+        out.write(reinterpret_cast<char const*>(&path_size), sizeof(path_size));
+        out.write(path.data(), path_size);
+    }
+
+    static char const* read_header(char const* data, char const* end, string const& path, uint64_t hash, uint64_t size)
+    {
+        auto read = [&](void* value, size_t count) {
+            if (static_cast<size_t>(end - data) < count) {
+                return false;
+            }
+            memcpy(value, data, count);
+            data += count;
+            return true;
+        };
+        auto matches = [&](char const* expected, size_t count) {
+            if (static_cast<size_t>(end - data) < count || memcmp(data, expected, count) != 0) {
+                return false;
+            }
+            data += count;
+            return true;
+        };
+
+        auto const& version = cache_version();
+        uint32_t format_version = 0;
+        uint64_t cached_hash = 0;
+        uint64_t cached_size = 0;
+        uint32_t version_size = 0;
+        uint32_t path_size = 0;
+        if (!matches(cache_magic, sizeof(cache_magic)) ||
+            !read(&format_version, sizeof(format_version)) || format_version != ast::format_version ||
+            !read(&cached_hash, sizeof(cached_hash)) || cached_hash != hash ||
+            !read(&cached_size, sizeof(cached_size)) || cached_size != size ||
+            !read(&version_size, sizeof(version_size)) || version_size != version.size() ||
+            !matches(version.data(), version_size) ||
+            !read(&path_size, sizeof(path_size)) || path_size != path.size() ||
+            !matches(path.data(), path_size)) {
+            return nullptr;
+        }
+        return data;
+    }
+
+    ast_cache::ast_cache(string directory) :
+        _directory(rvalue_cast(directory)),
+        _hits(0),
+        _misses(0)
+    {
+    }
+
+    string const& ast_cache::directory() const
+    {
+        return _directory;
+    }
+
+    shared_ptr<ast::syntax_tree> ast_cache::parse(logging::logger& logger, string const& path, compiler::module const* module)
+    {
+        // Read the file once so that a cache miss parses the same contents that were hashed
+        string source;
+        if (!read_file(path, source)) {
+            throw compilation_exception((boost::format("file '%1%' does not exist or cannot be read.") % path).str());
+        }
+        uint64_t hash = hash_bytes(source.data(), source.size());
+        uint64_t size = source.size();
+
+        // The cache file is named after the source path; the header is checked to guard against collisions
+        auto cache_path = (fs::path{ _directory } / (boost::format("%016x.ast") % hash_bytes(path.data(), path.size())).str()).string();
+
+        {
+            string cached;
+            if (read_file(cache_path, cached)) {
+                auto end = cached.data() + cached.size();
+                if (auto data = read_header(cached.data(), end, path, hash, size)) {
+                    if (auto tree = ast::deserialize(data, end - data, path, module)) {
+                        ++_hits;
+                        LOG(debug, "loaded cached AST for '%1%' from '%2%'.", path, cache_path);
+                        return tree;
+                    }
+                }
+            }
+        }
+
+        ++_misses;
+        auto tree = parser::parse_string(rvalue_cast(source), path, module);
+
+        // Write to a temporary file and rename it so that readers never see a partially written file
+        sys::error_code ec;
+        auto temporary = fs::unique_path(cache_path + ".%%%%-%%%%", ec).string();
+        if (!ec) {
+            {
+                ofstream out{ temporary, ios::binary };
+                write_header(out, path, hash, size);
+                ast::serialize(out, *tree);
+                if (!out) {
+                    ec = sys::errc::make_error_code(sys::errc::io_error);
+                }
+            }
+            if (!ec) {
+                fs::rename(temporary, cache_path, ec);
+            }
+            if (ec) {
+                sys::error_code ignored;
+                fs::remove(temporary, ignored);
+            }
+        }
+        if (ec) {
+            LOG(debug, "failed to store cached AST for '%1%' in '%2%': %3%.", path, _directory, ec.message());
+        }
+        return tree;
+    }
+
+    size_t ast_cache::hits() const
+    {
+        return _hits;
+    }
+
+    size_t ast_cache::misses() const
+    {
+        return _misses;
+    }
+
+}}  // namespace puppet::compiler
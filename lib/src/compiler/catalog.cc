@@ -1,10 +1,13 @@
 #include <puppet/compiler/catalog.hpp>
 #include <puppet/compiler/exceptions.hpp>
+#include <puppet/runtime/cbor_writer.hpp>
+#include <puppet/runtime/digest.hpp>
+#include <puppet/runtime/json_writer.hpp>
 #include <puppet/cast.hpp>
-#include <boost/graph/hawick_circuits.hpp>
+#include <boost/graph/strong_components.hpp>
 #include <boost/graph/graphviz.hpp>
-#include <rapidjson/document.h>
-#include <rapidjson/prettywriter.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/functional/hash.hpp>
 
 using namespace std;
 using namespace puppet::runtime;
@@ -49,9 +52,58 @@ namespace puppet { namespace compiler {
     }
 
     catalog::catalog(string node, string environment) :
+        _arena(new compiler::arena()),
         _node(rvalue_cast(node)),
         _environment(rvalue_cast(environment))
     {
+        digest_writer writer;
+        writer.string(_node);
+        writer.string(_environment);
+        _hash = writer.result();
+    }
+
+    catalog::catalog(catalog&& other) :
+        _arena(rvalue_cast(other._arena)),
+        _node(rvalue_cast(other._node)),
+        _environment(rvalue_cast(other._environment)),
+        _hash(other._hash),
+        _resources(rvalue_cast(other._resources)),
+        _resource_map(rvalue_cast(other._resource_map)),
+        _resource_lists(rvalue_cast(other._resource_lists)),
+        _indexes(rvalue_cast(other._indexes)),
+        _graph(rvalue_cast(other._graph)),
+        _edges(rvalue_cast(other._edges))
+    {
+        // The resources were moved with the deque's storage, but still refer to the other catalog
+        for (auto& resource : _resources) {
+            resource._catalog = this;
+        }
+    }
+
+    catalog& catalog::operator=(catalog&& other)
+    {
+        _node = rvalue_cast(other._node);
+        _environment = rvalue_cast(other._environment);
+        _hash = other._hash;
+        _resources = rvalue_cast(other._resources);
+        _resource_map = rvalue_cast(other._resource_map);
+        _resource_lists = rvalue_cast(other._resource_lists);
+        _indexes = rvalue_cast(other._indexes);
+        _graph = rvalue_cast(other._graph);
+        _edges = rvalue_cast(other._edges);
+
+        // Replace the arena last as the previous resources may refer to its memory
+        _arena = rvalue_cast(other._arena);
+
+        for (auto& resource : _resources) {
+            resource._catalog = this;
+        }
+        return *this;
+    }
+
+    compiler::arena& catalog::arena()
+    {
+        return *_arena;
     }
 
     string const& catalog::node() const
@@ -81,7 +133,7 @@ namespace puppet { namespace compiler {
             return nullptr;
         }
 
-        _resources.emplace_back(resource(rvalue_cast(type), container, context, exported));
+        _resources.emplace_back(resource(this, rvalue_cast(type), container, context, exported));
 
         auto resource = &_resources.back();
 
@@ -124,6 +176,11 @@ namespace puppet { namespace compiler {
         return _resources.size();
     }
 
+    digest const& catalog::hash() const
+    {
+        return _hash;
+    }
+
     void catalog::each(function<bool(resource&)> const& callback, string const& type, size_t offset)
     {
         // Adapt the given function so that we cast away const-ness of the resource
@@ -131,7 +188,7 @@ namespace puppet { namespace compiler {
             return callback(const_cast<resource&>(r));
         };
         // Enumerate the resources using the const overload
-        return static_cast<catalog const*>(this)->each(adapted, type);
+        return static_cast<catalog const*>(this)->each(adapted, type, offset);
     }
 
     void catalog::each(function<bool(resource const&)> const& callback, std::string const& type, size_t offset) const
@@ -159,6 +216,74 @@ namespace puppet { namespace compiler {
         }
     }
 
+    static void add_to_index(unordered_multimap<string, resource*>& index, resource& resource, values::value const& value)
+    {
+        if (auto str = value.as<string>()) {
+            index.emplace(boost::to_lower_copy(*str), &resource);
+            return;
+        }
+        if (auto array = value.as<values::array>()) {
+            for (auto const& element : *array) {
+                if (auto str = element.as<string>()) {
+                    index.emplace(boost::to_lower_copy(*str), &resource);
+                }
+            }
+        }
+    }
+
+    void catalog::each_matching(function<bool(resource&)> const& callback, string const& type, string const& attribute, string const& value)
+    {
+        auto& indexes = _indexes[type];
+        auto it = indexes.find(attribute);
+        if (it == indexes.end()) {
+            // Build the index from the existing resources of the type; later changes are indexed as attributes are set
+            it = indexes.emplace(attribute, unordered_multimap<string, resource*>{}).first;
+            auto list = _resource_lists.find(type);
+            if (list != _resource_lists.end()) {
+                for (auto resource : list->second) {
+                    if (auto existing = resource->get(attribute)) {
+                        add_to_index(it->second, *resource, existing->value());
+                    }
+                }
+            }
+        }
+
+        // Copy the matches as the callback may set attributes and modify the index
+        vector<resource*> matches;
+        auto range = it->second.equal_range(boost::to_lower_copy(value));
+        for (auto match = range.first; match != range.second; ++match) {
+            matches.push_back(match->second);
+        }
+
+        for (auto resource : matches) {
+            if (!callback(*resource)) {
+                break;
+            }
+        }
+    }
+
+    void catalog::index(resource& resource, attribute const& attribute)
+    {
+        if (_indexes.empty()) {
+            return;
+        }
+        auto indexes = _indexes.find(resource.type().type_name());
+        if (indexes == _indexes.end()) {
+            return;
+        }
+        auto index = indexes->second.find(attribute.name());
+        if (index == indexes->second.end()) {
+            return;
+        }
+        add_to_index(index->second, resource, attribute.value());
+    }
+
+    void catalog::rehash(digest const& previous, digest const& current)
+    {
+        _hash -= previous;
+        _hash += current;
+    }
+
     void catalog::each_edge(compiler::resource const& resource, function<bool(relationship, compiler::resource const&)> const& callback) const
     {
         if (resource.virtualized()) {
@@ -192,12 +317,32 @@ namespace puppet { namespace compiler {
         }
 
         // Add the edge to the graph if it doesn't already exist
-        for (auto const& edge : make_iterator_range(boost::out_edges(source_ptr->vertex_id(), _graph))) {
-            if (_graph[boost::target(edge, _graph)] == target_ptr && _graph[edge] == relation) {
-                return;
-            }
+        if (!_edges.insert(edge{ source_ptr->vertex_id(), target_ptr->vertex_id(), relation }).second) {
+            return;
         }
         boost::add_edge(source_ptr->vertex_id(), target_ptr->vertex_id(), relation, _graph);
+
+        digest_writer writer;
+        writer.number(static_cast<int64_t>(relation));
+        writer.string(source_ptr->type().type_name());
+        writer.string(source_ptr->type().title());
+        writer.string(target_ptr->type().type_name());
+        writer.string(target_ptr->type().title());
+        _hash += writer.result();
+    }
+
+    bool catalog::edge::operator==(edge const& other) const
+    {
+        return source == other.source && target == other.target && relation == other.relation;
+    }
+
+    size_t catalog::edge_hasher::operator()(edge const& value) const
+    {
+        size_t seed = 0;
+        boost::hash_combine(seed, value.source);
+        boost::hash_combine(seed, value.target);
+        boost::hash_combine(seed, static_cast<int>(value.relation));
+        return seed;
     }
 
     void catalog::realize(compiler::resource& resource)
@@ -206,8 +351,9 @@ namespace puppet { namespace compiler {
             return;
         }
 
-        // Realize the resource
+        // Realize the resource; only realized resources contribute to the digest
         resource.realize(boost::add_vertex(&resource, _graph));
+        _hash += resource.hash();
 
         // Add a relationship from container to this resource
         if (resource.container()) {
@@ -238,104 +384,172 @@ namespace puppet { namespace compiler {
         }
     }
 
-    void catalog::write(ostream& out) const
+    void catalog::write(ostream& out, catalog_format format, bool pretty, catalog_summary const* previous) const
     {
-        // Declare an adapter for RapidJSON's pretty writter
-        struct stream_adapter
-        {
-            explicit stream_adapter(ostream& stream) : _stream(stream)
-            {
-            }
-
-            void Put(char c)
-            {
-                _stream.put(c);
-            }
-
-            void Flush()
-            {
+        // Stream the catalog rather than building a document so that memory use does not grow with the catalog
+        auto write_to = [&](data_writer& writer) {
+            if (previous) {
+                write(writer, *previous);
+            } else {
+                write(writer);
             }
+            writer.flush();
+        };
 
-        private:
-            ostream& _stream;
-        } adapter(out);
-
-        // Create the document and treat it as an object
-        json_document document;
-        document.SetObject();
+        if (format == catalog_format::cbor) {
+            cbor_writer writer{out};
+            write_to(writer);
+            return;
+        }
 
-        auto& allocator = document.GetAllocator();
+        json_writer writer{out, pretty};
+        write_to(writer);
 
-        // Create an array to store the classes
-        json_value classes;
-        classes.SetArray();
+        // Flush the stream with one last newline
+        out << endl;
+    }
 
-        // Create an array to store the resources
-        json_value resources;
-        resources.SetArray();
-        resources.Reserve(_resources.size(),allocator);
+    void catalog::write(data_writer& writer) const
+    {
+        writer.start_object();
 
-        // Create an array to store the dependency edges
-        json_value edges;
-        edges.SetArray();
+        // Write out the catalog attributes
+        writer.key("name");
+        writer.string(_node);
+        writer.key("version");
+        writer.number(static_cast<int64_t>(std::time(nullptr)));
+        writer.key("environment");
+        writer.string(_environment);
+        writer.key("hash");
+        writer.string(_hash.to_string());
 
+        // Write out the resources
+        writer.key("resources");
+        writer.start_array();
         for (auto const& resource : _resources) {
             // Skip virtual resources
             if (resource.virtualized()) {
                 continue;
             }
+            resource.write(writer, *this);
+        }
+        writer.end_array();
 
-            if (resource.type().is_class()) {
-                auto& title = resource.type().title();
-                classes.PushBack(rapidjson::StringRef(title.c_str(), title.size()), allocator);
+        // Write out the containment edges
+        writer.key("edges");
+        writer.start_array();
+        for (auto const& resource : _resources) {
+            if (resource.virtualized()) {
+                continue;
             }
-
-            // Add the resource
-            resources.PushBack(resource.to_json(allocator, *this), allocator);
-
-            // Add the edges for this resource
             each_edge(resource, [&](relationship relation, compiler::resource const& target) {
                 if (relation != relationship::contains) {
                     // The top level edges are only containment edges
                     return true;
                 }
-                // Create an edge object from source to target
-                json_value edge;
-                edge.SetObject();
-                edge.AddMember(
-                    "source",
-                    json_value(boost::lexical_cast<string>(resource.type()).c_str(), allocator),
-                    allocator);
-                edge.AddMember(
-                    "target",
-                    json_value(boost::lexical_cast<string>(target.type()).c_str(), allocator),
-                    allocator);
-                edges.PushBack(rvalue_cast(edge), allocator);
+                writer.start_object();
+                writer.key("source");
+                writer.string(boost::lexical_cast<string>(resource.type()));
+                writer.key("target");
+                writer.string(boost::lexical_cast<string>(target.type()));
+                writer.end_object();
                 return true;
             });
         }
+        writer.end_array();
 
-        // Write out the catalog attributes
-        document.AddMember("name", rapidjson::StringRef(_node.c_str(), _node.size()), allocator);
-        document.AddMember("version", static_cast<int64_t>(std::time(nullptr)), allocator);
-        document.AddMember("environment", rapidjson::StringRef(_environment.c_str(), _environment.size()), allocator);
-
-        // Write out the resources
-        document.AddMember("resources", rvalue_cast(resources), allocator);
+        // Write out the declared classes
+        writer.key("classes");
+        writer.start_array();
+        for (auto const& resource : _resources) {
+            if (!resource.virtualized() && resource.type().is_class()) {
+                writer.string(resource.type().title());
+            }
+        }
+        writer.end_array();
 
-        // Write out the containment edges
-        document.AddMember("edges", rvalue_cast(edges), allocator);
+        writer.end_object();
+    }
 
-        // Write out the declared classes
-        document.AddMember("classes", rvalue_cast(classes), allocator);
+    void catalog::write(data_writer& writer, catalog_summary const& previous) const
+    {
+        // Summarize this catalog the same way the previous catalog was summarized so that the resource digests are comparable
+        catalog_summary current;
+        write(current);
 
-        // Write the document to the stream
-        rapidjson::PrettyWriter<stream_adapter> writer{adapter};
-        writer.SetIndent(' ', 2);
-        document.Accept(writer);
+        writer.start_object();
 
-        // Flush the stream with one last newline
-        out << endl;
+        // Write out the catalog attributes
+        writer.key("name");
+        writer.string(_node);
+        writer.key("version");
+        writer.number(static_cast<int64_t>(std::time(nullptr)));
+        writer.key("environment");
+        writer.string(_environment);
+        writer.key("hash");
+        writer.string(_hash.to_string());
+        writer.key("previous_hash");
+        if (previous.catalog_hash().empty()) {
+            writer.null();
+        } else {
+            writer.string(previous.catalog_hash());
+        }
+        writer.key("unchanged");
+        writer.boolean(!previous.catalog_hash().empty() && previous.catalog_hash() == _hash.to_string());
+
+        // Write out the resources that were added, changed, or removed
+        writer.key("resources");
+        writer.start_object();
+        for (bool added : { true, false }) {
+            writer.key(added ? "added" : "changed");
+            writer.start_array();
+            for (auto const& resource : _resources) {
+                if (resource.virtualized()) {
+                    continue;
+                }
+                auto reference = boost::lexical_cast<string>(resource.type());
+                auto found = previous.find(reference);
+                if (added ? !found : (found && *found != *current.find(reference))) {
+                    resource.write(writer, *this);
+                }
+            }
+            writer.end_array();
+        }
+        writer.key("removed");
+        writer.start_array();
+        for (auto const& kvp : previous.resources()) {
+            if (!current.find(kvp.first)) {
+                writer.string(kvp.first);
+            }
+        }
+        writer.end_array();
+        writer.end_object();
+
+        // Write out the containment edges that were added or removed
+        auto write_edges = [&](catalog_summary const& from, catalog_summary const& excluding) {
+            writer.start_array();
+            for (auto const& edge : from.edges()) {
+                if (excluding.edges().count(edge)) {
+                    continue;
+                }
+                writer.start_object();
+                writer.key("source");
+                writer.string(edge.first);
+                writer.key("target");
+                writer.string(edge.second);
+                writer.end_object();
+            }
+            writer.end_array();
+        };
+        writer.key("edges");
+        writer.start_object();
+        writer.key("added");
+        write_edges(current, previous);
+        writer.key("removed");
+        write_edges(previous, current);
+        writer.end_object();
+
+        writer.end_object();
     }
 
     void catalog::write_graph(ostream& out)
@@ -364,43 +578,105 @@ namespace puppet { namespace compiler {
         out << "}\n";
     }
 
-    struct cycle_visitor
+    void catalog::detect_cycles()
     {
-        explicit cycle_visitor(vector<string>& cycles) :
-            _cycles(cycles)
-        {
+        using vertex_type = decltype(_graph)::vertex_descriptor;
+
+        // Find the strongly connected components in linear time
+        // A cycle exists only in a component of more than one vertex or in a component of a vertex with an edge to itself
+        auto vertex_count = boost::num_vertices(_graph);
+        vector<size_t> components(vertex_count);
+        auto component_count = boost::strong_components(_graph, boost::make_iterator_property_map(components.begin(), boost::get(boost::vertex_index, _graph)));
+
+        vector<size_t> sizes(component_count);
+        for (auto component : components) {
+            ++sizes[component];
+        }
+        vector<bool> cyclic(component_count);
+        for (vertex_type vertex = 0; vertex < vertex_count; ++vertex) {
+            auto component = components[vertex];
+            if (sizes[component] > 1) {
+                cyclic[component] = true;
+                continue;
+            }
+            for (auto const& edge : boost::make_iterator_range(boost::out_edges(vertex, _graph))) {
+                if (boost::target(edge, _graph) == vertex) {
+                    cyclic[component] = true;
+                    break;
+                }
+            }
+        }
+        if (none_of(cyclic.begin(), cyclic.end(), [](bool value) { return value; })) {
+            return;
         }
 
-        template <typename Path, typename Graph>
-        void cycle(Path const& path, Graph const& graph)
-        {
+        // Report one representative cycle for each cyclic component, starting at the component's first vertex
+        // The shortest cycle through that vertex is found with a breadth-first search restricted to the component
+        vector<string> cycles;
+        vector<bool> reported(component_count);
+        vector<vertex_type> parents(vertex_count);
+        vector<bool> visited(vertex_count);
+        for (vertex_type start = 0; start < vertex_count; ++start) {
+            auto component = components[start];
+            if (!cyclic[component] || reported[component]) {
+                continue;
+            }
+            reported[component] = true;
+
+            vector<vertex_type> searched{ start };
+            deque<vertex_type> queue{ start };
+            visited[start] = true;
+            vertex_type last = start;
+            bool found = false;
+            while (!queue.empty() && !found) {
+                auto current = queue.front();
+                queue.pop_front();
+                for (auto const& edge : boost::make_iterator_range(boost::out_edges(current, _graph))) {
+                    auto target = boost::target(edge, _graph);
+                    if (components[target] != component) {
+                        continue;
+                    }
+                    if (target == start) {
+                        last = current;
+                        found = true;
+                        break;
+                    }
+                    if (!visited[target]) {
+                        visited[target] = true;
+                        searched.push_back(target);
+                        parents[target] = current;
+                        queue.push_back(target);
+                    }
+                }
+            }
+
+            // Reset only the searched vertices so that each search is linear in the size of its component
+            for (auto vertex : searched) {
+                visited[vertex] = false;
+            }
+
+            // Every vertex in a cyclic component is on a cycle, so the search always finds one
+            vector<vertex_type> path;
+            for (auto vertex = last; vertex != start; vertex = parents[vertex]) {
+                path.push_back(vertex);
+            }
+            path.push_back(start);
+            reverse(path.begin(), path.end());
+
             ostringstream cycle;
             bool first = true;
-            for (auto const& id : path) {
+            for (auto vertex : path) {
                 if (first) {
                     first = false;
                 } else {
                     cycle << " => ";
                 }
-                auto resource = graph[id];
+                auto resource = _graph[vertex];
                 cycle << resource->type() << " declared at " << resource->path() << ":" << resource->line();
             }
             // Append on the first vertex again to complete the cycle
-            auto resource = graph[path.front()];
-            cycle << " => " << resource->type();
-            _cycles.push_back(cycle.str());
-        }
-
-        vector<string>& _cycles;
-    };
-
-    void catalog::detect_cycles()
-    {
-        // Check for cycles in the graph
-        vector<string> cycles;
-        boost::hawick_unique_circuits(_graph, cycle_visitor(cycles));
-        if (cycles.empty()) {
-            return;
+            cycle << " => " << _graph[start]->type();
+            cycles.push_back(cycle.str());
         }
 
         // At least one cycle found, so throw an exception
@@ -0,0 +1,201 @@
+#include <puppet/compiler/catalog_summary.hpp>
+#include <puppet/runtime/cbor_reader.hpp>
+#include <puppet/runtime/json_reader.hpp>
+#include <puppet/cast.hpp>
+#include <cctype>
+#include <fstream>
+
+using namespace std;
+using namespace puppet::runtime;
+
+namespace puppet { namespace compiler {
+
+    // The depth of the members of each resource or edge object in a written catalog
+    static const size_t item_depth = 3;
+
+    catalog_summary::catalog_summary() :
+        _depth(0),
+        _empty(true)
+    {
+    }
+
+    bool catalog_summary::load(std::string const& path)
+    {
+        ifstream input{ path, ios::binary };
+        if (!input) {
+            return false;
+        }
+        std::string contents{ istreambuf_iterator<char>(input), istreambuf_iterator<char>() };
+        if (input.bad()) {
+            return false;
+        }
+
+        // A JSON catalog starts with an object; anything else is treated as CBOR
+        auto data = contents.data();
+        auto end = data + contents.size();
+        auto start = data;
+        while (start != end && isspace(static_cast<unsigned char>(*start))) {
+            ++start;
+        }
+        bool valid = (start != end && *start == '{') ? read_json(data, contents.size(), *this) : read_cbor(data, contents.size(), *this);
+        return valid && !_empty && _depth == 0;
+    }
+
+    bool catalog_summary::empty() const
+    {
+        return _empty;
+    }
+
+    std::string const& catalog_summary::catalog_hash() const
+    {
+        return _catalog_hash;
+    }
+
+    digest const* catalog_summary::find(std::string const& reference) const
+    {
+        auto it = _resources.find(reference);
+        if (it == _resources.end()) {
+            return nullptr;
+        }
+        return &it->second;
+    }
+
+    map<std::string, digest> const& catalog_summary::resources() const
+    {
+        return _resources;
+    }
+
+    set<catalog_summary::edge> const& catalog_summary::edges() const
+    {
+        return _edges;
+    }
+
+    void catalog_summary::null()
+    {
+        if (in_item()) {
+            _item_hash.null();
+        }
+    }
+
+    void catalog_summary::boolean(bool value)
+    {
+        if (in_item()) {
+            _item_hash.boolean(value);
+        }
+    }
+
+    void catalog_summary::number(int64_t value)
+    {
+        if (in_item()) {
+            _item_hash.number(value);
+        }
+    }
+
+    void catalog_summary::number(double value)
+    {
+        if (in_item()) {
+            _item_hash.number(value);
+        }
+    }
+
+    void catalog_summary::string(char const* value, size_t size)
+    {
+        if (_depth == 1 && _section == "hash") {
+            _catalog_hash.assign(value, size);
+        }
+        if (!in_item()) {
+            return;
+        }
+        _item_hash.string(value, size);
+
+        // Capture the resource's type and title or the edge's source and target
+        if (_depth != item_depth) {
+            return;
+        }
+        if (_member == "type" || _member == "source") {
+            _first.assign(value, size);
+        } else if (_member == "title" || _member == "target") {
+            _second.assign(value, size);
+        }
+    }
+
+    void catalog_summary::key(char const* name, size_t size)
+    {
+        if (_depth == 1) {
+            _section.assign(name, size);
+        } else if (_depth == item_depth) {
+            _member.assign(name, size);
+        }
+        if (in_item()) {
+            _item_hash.key(name, size);
+        }
+    }
+
+    void catalog_summary::start_object()
+    {
+        if (_depth == 0) {
+            _empty = false;
+        }
+        if (_depth == item_depth - 1) {
+            start_item();
+        }
+        ++_depth;
+        if (in_item()) {
+            _item_hash.start_object();
+        }
+    }
+
+    void catalog_summary::end_object()
+    {
+        if (in_item()) {
+            _item_hash.end_object();
+        }
+        --_depth;
+        if (_depth == item_depth - 1) {
+            end_item();
+        }
+    }
+
+    void catalog_summary::start_array()
+    {
+        ++_depth;
+        if (in_item()) {
+            _item_hash.start_array();
+        }
+    }
+
+    void catalog_summary::end_array()
+    {
+        if (in_item()) {
+            _item_hash.end_array();
+        }
+        --_depth;
+    }
+
+    void catalog_summary::flush()
+    {
+    }
+
+    bool catalog_summary::in_item() const
+    {
+        return _depth >= item_depth && (_section == "resources" || _section == "edges");
+    }
+
+    void catalog_summary::start_item()
+    {
+        _item_hash = digest_writer{};
+        _member.clear();
+        _first.clear();
+        _second.clear();
+    }
+
+    void catalog_summary::end_item()
+    {
+        if (_section == "resources") {
+            _resources[_first + "[" + _second + "]"] = _item_hash.result();
+        } else if (_section == "edges") {
+            _edges.emplace(rvalue_cast(_first), rvalue_cast(_second));
+        }
+    }
+
+}}  // namespace puppet::compiler
@@ -2,6 +2,7 @@
 #include <puppet/compiler/parser/parser.hpp>
 #include <puppet/compiler/evaluation/evaluator.hpp>
 #include <puppet/compiler/exceptions.hpp>
+#include <puppet/compiler/scheduler.hpp>
 #include <puppet/logging/logger.hpp>
 #include <puppet/cast.hpp>
 #include <boost/algorithm/string.hpp>
@@ -17,8 +18,14 @@ namespace puppet { namespace compiler {
     environment::environment(logging::logger& logger, compiler::settings const& settings, string name, string directory) :
         finder(rvalue_cast(directory)),
         _settings(settings),
-        _name(rvalue_cast(name))
+        _name(rvalue_cast(name)),
+        _preloaded(false)
     {
+        if (!_settings.ast_cache_directory().empty()) {
+            LOG(debug, "using directory '%1%' to cache parsed manifests.", _settings.ast_cache_directory());
+            _cache.reset(new ast_cache(_settings.ast_cache_directory()));
+        }
+
         // First load this module's directories
         // TODO: the modules subdirectory can come from an environment configuration file
         load_modules(logger, (fs::path{ this->directory() } / "modules").string());
@@ -58,50 +65,14 @@ namespace puppet { namespace compiler {
     {
         auto& logger = context.node().logger();
 
-        // If files to compile were explicitly specified, load those files only
+        // Load the manifests; they were already parsed concurrently if the environment was preloaded
+        auto manifests = find_manifests(logger);
         vector<shared_ptr<ast::syntax_tree>> trees;
-        if (!_settings.manifests().empty()) {
-            // Treat the files as if they come from the environment
-            for (auto const& manifest : _settings.manifests()) {
-                try {
-                    trees.emplace_back(import(logger, manifest));
-                } catch (parse_exception const& ex) {
-                    throw compilation_exception(ex, manifest);
-                }
-            }
-        } else {
-            // TODO: the "manifests" directory is a configuration setting; should not be hard coded
-            auto manifests_directory = fs::path{ directory() } / "manifests";
-
-            sys::error_code ec;
-            if (!fs::is_directory(manifests_directory, ec) || ec) {
-                // Base directory doesn't exist
-                LOG(debug, "manifest directory does not exist '%1%'.", manifests_directory.string());
-            } else {
-                LOG(debug, "loading manifests in '%1%'.", manifests_directory.string());
-
-                fs::directory_iterator it{manifests_directory};
-                fs::directory_iterator end{};
-
-                // Add the files to a vector
-                vector<string> manifests;
-                for (; it != end; ++it) {
-                    if (fs::is_regular_file(it->status()) && it->path().extension() == ".pp") {
-                        manifests.emplace_back(it->path().string());
-                    }
-                }
-
-                // Sort the paths so they are in a deterministic order
-                sort(manifests.begin(), manifests.end());
-
-                // Load the manifests
-                for (auto const& manifest : manifests) {
-                    try {
-                        trees.emplace_back(import(logger, manifest));
-                    } catch (parse_exception const& ex) {
-                        throw compilation_exception(ex, manifest);
-                    }
-                }
+        for (auto const& manifest : manifests) {
+            try {
+                trees.emplace_back(import(logger, manifest));
+            } catch (parse_exception const& ex) {
+                throw compilation_exception(ex, manifest);
             }
         }
 
@@ -135,12 +106,56 @@ namespace puppet { namespace compiler {
             LOG(debug, "evaluating node definition for node '%1%'.", name());
             result.first->evaluate(context, *resource);
         }
+
+        if (_cache) {
+            LOG(debug, "AST cache for environment '%1%' has %2% %3% and %4% %5%.",
+                _name,
+                _cache->hits(),
+                (_cache->hits() != 1 ? "hits" : "hit"),
+                _cache->misses(),
+                (_cache->misses() != 1 ? "misses" : "miss"));
+        }
     }
 
-    module* environment::find_module(string const& name)
+    vector<string> environment::find_manifests(logging::logger& logger) const
     {
-        // TODO: this function needs to be thread safe
+        // If files to compile were explicitly specified, load those files only
+        // Otherwise, treat the files as if they come from the environment
+        if (!_settings.manifests().empty()) {
+            return _settings.manifests();
+        }
+
+        // TODO: the "manifests" directory is a configuration setting; should not be hard coded
+        vector<string> manifests;
+        auto manifests_directory = fs::path{ directory() } / "manifests";
+
+        sys::error_code ec;
+        if (!fs::is_directory(manifests_directory, ec) || ec) {
+            // Base directory doesn't exist
+            LOG(debug, "manifest directory does not exist '%1%'.", manifests_directory.string());
+            return manifests;
+        }
+
+        LOG(debug, "loading manifests in '%1%'.", manifests_directory.string());
+
+        fs::directory_iterator it{manifests_directory};
+        fs::directory_iterator end{};
+
+        // Add the files to a vector
+        for (; it != end; ++it) {
+            if (fs::is_regular_file(it->status()) && it->path().extension() == ".pp") {
+                manifests.emplace_back(it->path().string());
+            }
+        }
+
+        // Sort the paths so they are in a deterministic order
+        sort(manifests.begin(), manifests.end());
+        return manifests;
+    }
 
+    module* environment::find_module(string const& name)
+    {
+        // Modules are only loaded during construction, so this is safe to call concurrently afterwards
         auto it = _modules.find(name);
         if (it == _modules.end()) {
             return nullptr;
@@ -178,16 +193,11 @@ namespace puppet { namespace compiler {
             path = module->find(type, qualified_name);
         }
 
+        // The module's index only contains files that exist
         if (path.empty()) {
             return;
         }
 
-        // Ignore files that don't exist
-        sys::error_code ec;
-        if (!fs::is_regular_file(path, ec)) {
-            return;
-        }
-
         // Import the file, but don't parse it if it's already been imported
         import(logger, path, module);
     }
@@ -229,34 +239,218 @@ namespace puppet { namespace compiler {
 
             LOG(debug, "found module '%1%' at '%2%'.", name, module_directory);
             module mod{ *this, module_directory, name };
+
+            // Index the module's files so that name resolution does not need to access the file system
+            mod.index();
             _modules.emplace(rvalue_cast(name), rvalue_cast(mod));
         }
     }
 
-    shared_ptr<ast::syntax_tree> environment::import(logging::logger& logger, string const& path, compiler::module const* module)
+    void environment::preload(logging::logger& logger)
+    {
+        _preloaded = true;
+
+        // Find the environment's manifests and every manifest in every module
+        vector<pair<string, compiler::module const*>> files;
+        for (auto& manifest : find_manifests(logger)) {
+            files.emplace_back(rvalue_cast(manifest), nullptr);
+        }
+        // Use each module's index rather than walking the module's directories again
+        for (auto const& kvp : _modules) {
+            kvp.second.each(find_type::manifest, [&](string const&, string const& path) {
+                files.emplace_back(path, &kvp.second);
+                return true;
+            });
+        }
+
+        // Sort the paths so they are in a deterministic order
+        sort(files.begin(), files.end(), [](pair<string, compiler::module const*> const& left, pair<string, compiler::module const*> const& right) {
+            return left.first < right.first;
+        });
+
+        LOG(debug, "preloading %1% module %2% into environment '%3%'.", files.size(), (files.size() != 1 ? "manifests" : "manifest"), _name);
+        parse_all(logger, rvalue_cast(files));
+    }
+
+    size_t environment::refresh(logging::logger& logger)
+    {
+        auto changed = refresh_files(logger);
+
+        // Parse any files that were added since the environment was preloaded
+        if (_preloaded) {
+            preload(logger);
+        }
+        return changed;
+    }
+
+    size_t environment::refresh_files(logging::logger& logger)
     {
-        // TODO: this needs to be made thread safe
+        lock_guard<mutex> lock{ _mutex };
+
+        // Index the modules again to pick up added and removed files
+        for (auto& kvp : _modules) {
+            kvp.second.index();
+        }
+
+        // Find the files that have changed since they were parsed
+        // Process them in path order so that re-registering definitions is deterministic
+        vector<string> paths;
+        for (auto const& kvp : _parsed) {
+            paths.push_back(kvp.first);
+        }
+        sort(paths.begin(), paths.end());
+
+        size_t changed = 0;
+        for (auto const& path : paths) {
+            auto& file = _parsed[path];
+
+            time_t modified;
+            uintmax_t size;
+            bool exists = stat(path, modified, size);
+            if (exists && modified == file.modified && size == file.size) {
+                continue;
+            }
+
+            ++changed;
+            if (file.imported) {
+                _registry.unregister(*file.tree);
+            }
 
+            if (!exists) {
+                LOG(debug, "removing '%1%' from environment '%2%' because the file no longer exists.", path, _name);
+                _parsed.erase(path);
+                continue;
+            }
+
+            LOG(debug, "reloading '%1%' into environment '%2%' because the file has changed.", path, _name);
+            try {
+                file.tree = parse(logger, path, file.module);
+                file.modified = modified;
+                file.size = size;
+
+                // Only import files that were imported before; preloaded files are still registered on demand
+                if (file.imported) {
+                    _registry.import(*file.tree);
+                }
+            } catch (parse_exception const& ex) {
+                // Leave the file to be parsed again when next imported so the error is reported by the compilation
+                LOG(debug, "failed to reload '%1%': %2%", path, ex.what());
+                _parsed.erase(path);
+            }
+        }
+
+        if (changed > 0) {
+            LOG(info, "refreshed %1% changed %2% in environment '%3%'.", changed, (changed != 1 ? "files" : "file"), _name);
+        }
+        return changed;
+    }
+
+    shared_ptr<ast::syntax_tree> environment::import(logging::logger& logger, string const& path, compiler::module const* module)
+    {
         try {
             shared_ptr<ast::syntax_tree> tree;
 
+            // Hold the lock while parsing so that concurrent imports of the same file only parse it once
+            lock_guard<mutex> lock{ _mutex };
+
             // Check for a already parsed AST
             auto it = _parsed.find(path);
             if (it != _parsed.end()) {
                 LOG(debug, "using cached AST for '%1%' in environment '%2%'.", path, _name);
-                tree = it->second;
+                tree = it->second.tree;
             } else {
+                // Record the file's modification time and size before parsing so that a concurrent change is detected on refresh
+                parsed_file file;
+                file.module = module;
+                if (!stat(path, file.modified, file.size)) {
+                    file.modified = 0;
+                    file.size = 0;
+                }
+
                 // Parse the file
                 LOG(debug, "loading '%1%' into environment '%2%'.", path, _name);
-                tree = parser::parse_file(path, module);
+                tree = parse(logger, path, module);
                 LOG(debug, "parsed AST for '%1%':\n-----\n%2%\n-----", path, *tree);
-                _parsed.emplace(path, tree);
+                file.tree = tree;
+                file.imported = false;
+                it = _parsed.emplace(path, rvalue_cast(file)).first;
             }
             _registry.import(*tree);
+            it->second.imported = true;
             return tree;
         } catch (parse_exception const& ex) {
             throw compilation_exception(ex, path);
         }
     }
 
+    void environment::parse_all(logging::logger& logger, vector<pair<string, compiler::module const*>> files)
+    {
+        // Only parse the files that have not already been parsed
+        {
+            lock_guard<mutex> lock{ _mutex };
+            files.erase(
+                remove_if(files.begin(), files.end(), [&](pair<string, compiler::module const*> const& file) { return _parsed.count(file.first) > 0; }),
+                files.end());
+        }
+        if (files.size() < 2) {
+            return;
+        }
+
+        // Parsing does not modify the environment, so each file is parsed in its own task
+        vector<parsed_file> results(files.size());
+        {
+            compiler::scheduler scheduler{ min(_settings.jobs(), files.size()) };
+            LOG(debug, "parsing %1% files using %2% threads.", files.size(), scheduler.threads());
+
+            for (size_t i = 0; i < files.size(); ++i) {
+                scheduler.queue([&, i]() {
+                    auto& path = files[i].first;
+                    auto& result = results[i];
+                    result.module = files[i].second;
+                    result.imported = false;
+                    if (!stat(path, result.modified, result.size)) {
+                        result.modified = 0;
+                        result.size = 0;
+                    }
+                    try {
+                        result.tree = parse(logger, path, result.module);
+                    } catch (parse_exception const&) {
+                        // Leave the file to be parsed again when imported so the error is reported by the compilation
+                    } catch (compilation_exception const&) {
+                        // The file could not be read; this is also reported when the file is imported
+                    }
+                });
+            }
+            scheduler.wait();
+        }
+
+        // Store the parsed trees; they are registered when imported so that registration remains in a deterministic order
+        // Parsing is done without the lock, so keep any tree that was imported in the meantime
+        lock_guard<mutex> lock{ _mutex };
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (results[i].tree) {
+                _parsed.emplace(rvalue_cast(files[i].first), rvalue_cast(results[i]));
+            }
+        }
+    }
+
+    shared_ptr<ast::syntax_tree> environment::parse(logging::logger& logger, string const& path, compiler::module const* module)
+    {
+        if (_cache) {
+            return _cache->parse(logger, path, module);
+        }
+        return parser::parse_file(path, module);
+    }
+
+    bool environment::stat(string const& path, time_t& modified, uintmax_t& size)
+    {
+        sys::error_code ec;
+        modified = fs::last_write_time(path, ec);
+        if (ec) {
+            return false;
+        }
+        size = fs::file_size(path, ec);
+        return !ec;
+    }
+
 }}  // namespace puppet::compiler
@@ -47,9 +47,9 @@ namespace puppet { namespace compiler { namespace evaluation {
             }
 
             // Get the index
-            auto ptr = _arguments[0]->as<int64_t>();
+            auto ptr = _arguments[0].as<int64_t>();
             if (!ptr) {
-                throw evaluation_exception((boost::format("expected %1% for start index but found %2%.") % integer::name() % _arguments[0]->get_type()).str(), _contexts[0]);
+                throw evaluation_exception((boost::format("expected %1% for start index but found %2%.") % integer::name() % _arguments[0].get_type()).str(), _contexts[0]);
             }
 
             // If the index is negative, it's from the end of the string
@@ -61,9 +61,9 @@ namespace puppet { namespace compiler { namespace evaluation {
             // Get the count
             int64_t count = 1;
             if (_arguments.size() == 2) {
-                ptr = _arguments[1]->as<int64_t>();
+                ptr = _arguments[1].as<int64_t>();
                 if (!ptr) {
-                    throw evaluation_exception((boost::format("expected %1% for count but found %2%.") % integer::name() % _arguments[1]->get_type()).str(), _contexts[1]);
+                    throw evaluation_exception((boost::format("expected %1% for count but found %2%.") % integer::name() % _arguments[1].get_type()).str(), _contexts[1]);
                 }
                 count = *ptr;
 
@@ -102,9 +102,9 @@ namespace puppet { namespace compiler { namespace evaluation {
             }
 
             // Get the index
-            auto ptr = _arguments[0]->as<int64_t>();
+            auto ptr = _arguments[0].as<int64_t>();
             if (!ptr) {
-                throw evaluation_exception((boost::format("expected %1% for start index but found %2%.") % integer::name() % _arguments[0]->get_type()).str(), _contexts[0]);
+                throw evaluation_exception((boost::format("expected %1% for start index but found %2%.") % integer::name() % _arguments[0].get_type()).str(), _contexts[0]);
             }
 
             // If the index is negative, it's from the end of the array
@@ -116,9 +116,9 @@ namespace puppet { namespace compiler { namespace evaluation {
             // Get the count
             int64_t count = 1;
             if (_arguments.size() == 2) {
-                ptr = _arguments[1]->as<int64_t>();
+                ptr = _arguments[1].as<int64_t>();
                 if (!ptr) {
-                    throw evaluation_exception((boost::format("expected %1% for count but found %2%.") % integer::name() % _arguments[1]->get_type()).str(), _contexts[1]);
+                    throw evaluation_exception((boost::format("expected %1% for count but found %2%.") % integer::name() % _arguments[1].get_type()).str(), _contexts[1]);
                 }
                 count = *ptr;
 
@@ -223,14 +223,14 @@ namespace puppet { namespace compiler { namespace evaluation {
 
             // Get the pattern argument; check for regex argument first
             std::string pattern;
-            auto regex = _arguments[0]->as<values::regex>();
+            auto regex = _arguments[0].as<values::regex>();
             if (regex) {
                 pattern = regex->pattern();
             } else {
-                if (!_arguments[0]->as<std::string>()) {
-                    throw evaluation_exception((boost::format("expected parameter to be %1% or %2% but found %3%.") % types::string::name() % regexp::name() % _arguments[0]->get_type()).str(), _contexts[0]);
+                if (!_arguments[0].as<std::string>()) {
+                    throw evaluation_exception((boost::format("expected parameter to be %1% or %2% but found %3%.") % types::string::name() % regexp::name() % _arguments[0].get_type()).str(), _contexts[0]);
                 }
-                pattern = _arguments[0]->move_as<std::string>();
+                pattern = _arguments[0].move_as<std::string>();
             }
             return regexp(rvalue_cast(pattern));
         }
@@ -242,10 +242,10 @@ namespace puppet { namespace compiler { namespace evaluation {
             strings.reserve(_arguments.size());
 
             for (size_t i = 0; i < _arguments.size(); ++i) {
-                if (!_arguments[i]->as<std::string>()) {
-                    throw evaluation_exception((boost::format("expected %1% but found %2%.") % types::string::name() % _arguments[i]->get_type()).str(), _contexts[i]);
+                if (!_arguments[i].as<std::string>()) {
+                    throw evaluation_exception((boost::format("expected %1% but found %2%.") % types::string::name() % _arguments[i].get_type()).str(), _contexts[i]);
                 }
-                strings.emplace_back(_arguments[i]->move_as<std::string>());
+                strings.emplace_back(_arguments[i].move_as<std::string>());
             }
             return enumeration(rvalue_cast(strings));
         }
@@ -258,17 +258,17 @@ namespace puppet { namespace compiler { namespace evaluation {
             // Each argument can be a string, regex value, Regexp type or another Pattern type
             for (size_t i = 0; i < _arguments.size(); ++i) {
                 // Check for string
-                if (_arguments[i]->as<std::string>()) {
-                    patterns.emplace_back(_arguments[i]->move_as<std::string>());
+                if (_arguments[i].as<std::string>()) {
+                    patterns.emplace_back(_arguments[i].move_as<std::string>());
                     continue;
                 }
                 // Check for regex
-                if (_arguments[i]->as<values::regex>()) {
-                    patterns.emplace_back(_arguments[i]->move_as<values::regex>());
+                if (_arguments[i].as<values::regex>()) {
+                    patterns.emplace_back(_arguments[i].move_as<values::regex>());
                     continue;
                 }
                 // Check for Type
-                auto type = _arguments[i]->as<values::type>();
+                auto type = _arguments[i].as<values::type>();
                 if (type) {
                     auto regexp = boost::get<types::regexp>(type);
                     if (regexp) {
@@ -288,7 +288,7 @@ namespace puppet { namespace compiler { namespace evaluation {
                          types::string::name() %
                          regexp::name() %
                          pattern::name() %
-                         _arguments[i]->get_type()
+                         _arguments[i].get_type()
                     ).str(),
                     _contexts[i]);
             }
@@ -303,14 +303,14 @@ namespace puppet { namespace compiler { namespace evaluation {
             }
 
             // First argument should be a type
-            if (!_arguments[0]->as<values::type>()) {
-                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::type::name() % _arguments[0]->get_type()).str(), _contexts[0]);
+            if (!_arguments[0].as<values::type>()) {
+                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::type::name() % _arguments[0].get_type()).str(), _contexts[0]);
             }
 
             // Get the optional range
             size_t from, to;
             tie(from, to) = get_range<int64_t, integer>(true, 1);
-            return types::array(make_unique<values::type>(_arguments[0]->move_as<values::type>()), from, to);
+            return types::array(make_unique<values::type>(_arguments[0].move_as<values::type>()), from, to);
         }
 
         value operator()(types::hash const& target)
@@ -324,21 +324,21 @@ namespace puppet { namespace compiler { namespace evaluation {
             }
 
             // First argument should be a type
-            if (!_arguments[0]->as<values::type>()) {
-                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::type::name() % _arguments[0]->get_type()).str(), _contexts[0]);
+            if (!_arguments[0].as<values::type>()) {
+                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::type::name() % _arguments[0].get_type()).str(), _contexts[0]);
             }
 
             // Second argument should be a type
-            if (!_arguments[1]->as<values::type>()) {
-                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::type::name() % _arguments[1]->get_type()).str(), _contexts[1]);
+            if (!_arguments[1].as<values::type>()) {
+                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::type::name() % _arguments[1].get_type()).str(), _contexts[1]);
             }
 
             // Get the optional range
             size_t from, to;
             tie(from, to) = get_range<int64_t, integer>(true, 2);
             return types::hash(
-                make_unique<values::type>(_arguments[0]->move_as<values::type>()),
-                make_unique<values::type>(_arguments[1]->move_as<values::type>()),
+                make_unique<values::type>(_arguments[0].move_as<values::type>()),
+                make_unique<values::type>(_arguments[1].move_as<values::type>()),
                 from,
                 to);
         }
@@ -352,7 +352,7 @@ namespace puppet { namespace compiler { namespace evaluation {
             int64_t to = _arguments.size();
             for (size_t i = 0; i < _arguments.size(); ++i) {
                 // Stop at first parameter that isn't a type
-                if (!_arguments[i]->as<values::type>()) {
+                if (!_arguments[i].as<values::type>()) {
                     // There must be at most 2 more parameters (the range)
                     if ((i + 2) < _arguments.size()) {
                         throw evaluation_exception((boost::format("expected at most %1% arguments for %2% but %3% were given.") % (i + 2) % types::tuple::name() % _arguments.size()).str(), _contexts[i + 2]);
@@ -361,7 +361,7 @@ namespace puppet { namespace compiler { namespace evaluation {
                     tie(from, to) = get_range<int64_t, integer>(true, i);
                     break;
                 }
-                types.emplace_back(new values::type(_arguments[i]->move_as<values::type>()));
+                types.emplace_back(new values::type(_arguments[i].move_as<values::type>()));
             }
             return types::tuple(rvalue_cast(types), from, to);
         }
@@ -374,20 +374,20 @@ namespace puppet { namespace compiler { namespace evaluation {
             }
 
             // Check for type argument
-            if (_arguments[0]->as<values::type>()) {
-                return types::optional(make_unique<values::type>(_arguments[0]->move_as<values::type>()));
+            if (_arguments[0].as<values::type>()) {
+                return types::optional(make_unique<values::type>(_arguments[0].move_as<values::type>()));
             }
             // Check for string argument (treat as Optional[Enum[<string>]])
-            if (_arguments[0]->as<std::string>()) {
+            if (_arguments[0].as<std::string>()) {
                 vector<std::string> values;
-                values.emplace_back(_arguments[0]->move_as<std::string>());
+                values.emplace_back(_arguments[0].move_as<std::string>());
                 return types::optional(make_unique<values::type>(types::enumeration(rvalue_cast(values))));
             }
             throw evaluation_exception(
                 (boost::format("expected parameter to be %1% or %2% but found %3%.") %
                  types::type::name() %
                  types::string::name() %
-                 _arguments[0]->get_type()
+                 _arguments[0].get_type()
                 ).str(),
                 _contexts[0]);
         }
@@ -400,20 +400,20 @@ namespace puppet { namespace compiler { namespace evaluation {
             }
 
             // Check for type argument
-            if (_arguments[0]->as<values::type>()) {
-                return types::not_undef(make_unique<values::type>(_arguments[0]->move_as<values::type>()));
+            if (_arguments[0].as<values::type>()) {
+                return types::not_undef(make_unique<values::type>(_arguments[0].move_as<values::type>()));
             }
             // Check for string argument (treat as Optional[Enum[<string>]])
-            if (_arguments[0]->as<std::string>()) {
+            if (_arguments[0].as<std::string>()) {
                 vector<std::string> values;
-                values.emplace_back(_arguments[0]->move_as<std::string>());
+                values.emplace_back(_arguments[0].move_as<std::string>());
                 return types::not_undef(make_unique<values::type>(types::enumeration(rvalue_cast(values))));
             }
             throw evaluation_exception(
                 (boost::format("expected parameter to be %1% or %2% but found %3%.") %
                  types::type::name() %
                  types::string::name() %
-                 _arguments[0]->get_type()
+                 _arguments[0].get_type()
                 ).str(),
                 _contexts[0]);
         }
@@ -426,11 +426,11 @@ namespace puppet { namespace compiler { namespace evaluation {
             }
 
             // First argument should be a type
-            if (!_arguments[0]->as<values::type>()) {
-                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::type::name() % _arguments[0]->get_type()).str(), _contexts[0]);
+            if (!_arguments[0].as<values::type>()) {
+                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::type::name() % _arguments[0].get_type()).str(), _contexts[0]);
             }
 
-            return types::type(make_unique<values::type>(_arguments[0]->move_as<values::type>()));
+            return types::type(make_unique<values::type>(_arguments[0].move_as<values::type>()));
         }
 
         value operator()(structure const& target)
@@ -441,11 +441,11 @@ namespace puppet { namespace compiler { namespace evaluation {
             }
 
             // First argument should be a hash
-            if (!_arguments[0]->as<values::hash>()) {
-                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::hash::name() % _arguments[0]->get_type()).str(), _contexts[0]);
+            if (!_arguments[0].as<values::hash>()) {
+                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::hash::name() % _arguments[0].get_type()).str(), _contexts[0]);
             }
 
-            auto hash = _arguments[0]->move_as<values::hash>();
+            auto hash = _arguments[0].move_as<values::hash>();
 
             // Build a vector of key value pairs for the structure's schema
             structure::schema_type schema;
@@ -496,10 +496,10 @@ namespace puppet { namespace compiler { namespace evaluation {
             types.reserve(_arguments.size());
 
             for (size_t i = 0; i < _arguments.size(); ++i) {
-                if (!_arguments[i]->as<values::type>()) {
-                    throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::type::name() % _arguments[i]->get_type()).str(), _contexts[i]);
+                if (!_arguments[i].as<values::type>()) {
+                    throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::type::name() % _arguments[i].get_type()).str(), _contexts[i]);
                 }
-                types.emplace_back(make_unique<values::type>(_arguments[i]->move_as<values::type>()));
+                types.emplace_back(make_unique<values::type>(_arguments[i].move_as<values::type>()));
             }
             return variant(rvalue_cast(types));
         }
@@ -515,9 +515,9 @@ namespace puppet { namespace compiler { namespace evaluation {
             size_t offset = 0;
             auto type_name = target.type_name();
             if (type_name.empty()) {
-                if (_arguments[0]->as<std::string>()) {
-                    type_name = _arguments[0]->move_as<std::string>();
-                } else if (auto type = _arguments[0]->as<values::type>()) {
+                if (_arguments[0].as<std::string>()) {
+                    type_name = _arguments[0].move_as<std::string>();
+                } else if (auto type = _arguments[0].as<values::type>()) {
                     if (auto resource = boost::get<types::resource>(type)) {
                         type_name = resource->type_name();
                     }
@@ -525,7 +525,7 @@ namespace puppet { namespace compiler { namespace evaluation {
                 offset = 1;
             }
             if (type_name.empty()) {
-                throw evaluation_exception((boost::format("expected parameter to be %1% or typed %2% but found %3%.") % types::string::name() % types::resource::name() % _arguments[0]->get_type()).str(), _contexts[0]);
+                throw evaluation_exception((boost::format("expected parameter to be %1% or typed %2% but found %3%.") % types::string::name() % types::resource::name() % _arguments[0].get_type()).str(), _contexts[0]);
             }
 
             // Check for Resource['typename']
@@ -534,8 +534,8 @@ namespace puppet { namespace compiler { namespace evaluation {
             }
 
             // If there is only one additional string parameter, return a single resource
-            if (_arguments.size() == (offset + 1) && _arguments[offset]->as<std::string>()) {
-                return types::resource(type_name, _arguments[offset]->move_as<std::string>());
+            if (_arguments.size() == (offset + 1) && _arguments[offset].as<std::string>()) {
+                return types::resource(type_name, _arguments[offset].move_as<std::string>());
             }
 
             // Otherwise, return an array of resources with titles
@@ -554,8 +554,8 @@ namespace puppet { namespace compiler { namespace evaluation {
             }
 
             // If there is only one string parameter, return a single class
-            if (_arguments.size() == 1 && _arguments[0]->as<std::string>()) {
-                return types::klass(_arguments[0]->move_as<std::string>());
+            if (_arguments.size() == 1 && _arguments[0].as<std::string>()) {
+                return types::klass(_arguments[0].move_as<std::string>());
             }
 
             // Otherwise, return an array of classes with titles
@@ -574,18 +574,18 @@ namespace puppet { namespace compiler { namespace evaluation {
             }
 
             // First argument should be a string
-            if (!_arguments[0]->as<std::string>()) {
-                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::string::name() % _arguments[0]->get_type()).str(), _contexts[0]);
+            if (!_arguments[0].as<std::string>()) {
+                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::string::name() % _arguments[0].get_type()).str(), _contexts[0]);
             }
-            auto runtime_name = _arguments[0]->move_as<std::string>();
+            auto runtime_name = _arguments[0].move_as<std::string>();
 
             // Check for the optional type name
             std::string type_name;
             if (_arguments.size() > 1) {
-                if (!_arguments[1]->as<std::string>()) {
-                    throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::string::name() % _arguments[1]->get_type()).str(), _contexts[1]);
+                if (!_arguments[1].as<std::string>()) {
+                    throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::string::name() % _arguments[1].get_type()).str(), _contexts[1]);
                 }
-                type_name = _arguments[1]->move_as<std::string>();
+                type_name = _arguments[1].move_as<std::string>();
             }
             return types::runtime(rvalue_cast(runtime_name), rvalue_cast(type_name));
         }
@@ -601,7 +601,7 @@ namespace puppet { namespace compiler { namespace evaluation {
         {
             // Check for Integer range first
             if (accept_range && _arguments.size() > start_index) {
-                if (auto type = _arguments[start_index]->as<values::type>()) {
+                if (auto type = _arguments[start_index].as<values::type>()) {
                     if (auto integer = boost::get<types::integer>(type)) {
                         return make_tuple(integer->from(), integer->to());
                     }
@@ -613,14 +613,14 @@ namespace puppet { namespace compiler { namespace evaluation {
             if (_arguments.size() > start_index) {
                 auto& argument = _arguments[start_index];
 
-                if (!argument->is_default()) {
+                if (!argument.is_default()) {
                     // Try int64_t first; this allows either Integer or Floats when Value is floating point
-                    if (auto ptr = argument->as<int64_t>()) {
+                    if (auto ptr = argument.as<int64_t>()) {
                         from = static_cast<Value>(*ptr);
-                    } else if (auto ptr = argument->as<Value>()) {
+                    } else if (auto ptr = argument.as<Value>()) {
                         from = *ptr;
                     } else {
-                        throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % Type::name() % argument->get_type()).str(), _contexts[start_index]);
+                        throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % Type::name() % argument.get_type()).str(), _contexts[start_index]);
                     }
                 }
             }
@@ -629,14 +629,14 @@ namespace puppet { namespace compiler { namespace evaluation {
             if (_arguments.size() > (start_index + 1)) {
                 auto& argument = _arguments[start_index + 1];
 
-                if (!argument->is_default()) {
+                if (!argument.is_default()) {
                     // Try int64_t first; this allows either Integer or Floats when Value is floating point
-                    if (auto ptr = argument->as<int64_t>()) {
+                    if (auto ptr = argument.as<int64_t>()) {
                         to = static_cast<Value>(*ptr);
-                    } else if (auto ptr = argument->as<Value>()) {
+                    } else if (auto ptr = argument.as<Value>()) {
                         to = *ptr;
                     } else {
-                        throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % Type::name() % argument->get_type()).str(), _contexts[start_index + 1]);
+                        throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % Type::name() % argument.get_type()).str(), _contexts[start_index + 1]);
                     }
                 }
             }
@@ -696,11 +696,11 @@ namespace puppet { namespace compiler { namespace evaluation {
 
         value access_attribute(compiler::resource const& resource, size_t index)
         {
-            if (!_arguments[index]->as<std::string>()) {
-                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::string::name() % _arguments[index]->get_type()).str(), _contexts[index]);
+            if (!_arguments[index].as<std::string>()) {
+                throw evaluation_exception((boost::format("expected parameter to be %1% but found %2%.") % types::string::name() % _arguments[index].get_type()).str(), _contexts[index]);
             }
             // Lookup the attribute
-            auto name = _arguments[index]->move_as<std::string>();
+            auto name = _arguments[index].move_as<std::string>();
             auto attribute = resource.get(name);
             if (!attribute) {
                 throw evaluation_exception((boost::format("resource %1% does not have an attribute named '%2%'.") % resource.type() % name).str(), _contexts[index]);
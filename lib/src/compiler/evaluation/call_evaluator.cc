@@ -166,6 +166,8 @@ namespace puppet { namespace compiler { namespace evaluation {
 
     values::value call_evaluator::evaluate(compiler::resource& resource, shared_ptr<scope> const& scope) const
     {
+        auto& arena = _context.catalog().arena();
+
         // Create the local scope
         auto local_scope = _context.create_local_scope(scope);
         auto& current_scope = _context.current_scope();
@@ -206,10 +208,10 @@ namespace puppet { namespace compiler { namespace evaluation {
             });
 
             // Set the parameter as an attribute on the resource
-            resource.set(std::make_shared<attribute>(
+            resource.set(arena.make_shared<attribute>(
                 parameter.variable.name,
                 parameter.context(),
-                std::make_shared<values::value>(rvalue_cast(value)),
+                arena.make_shared<values::value>(rvalue_cast(value)),
                 parameter.default_value->context()
             ));
         }
@@ -1,5 +1,4 @@
 #include <puppet/compiler/evaluation/collectors/query_collector.hpp>
-#include <puppet/compiler/evaluation/collectors/query_evaluator.hpp>
 #include <puppet/compiler/evaluation/context.hpp>
 #include <puppet/cast.hpp>
 
@@ -26,21 +25,66 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
         // Change to the stored scope
         local_scope scope{ context, _scope };
 
-        query_evaluator evaluator{ context, _expression.query };
+        // Evaluate the query's operands once; only dynamic operands are evaluated again on later collections
+        if (!_evaluator) {
+            _evaluator.reset(new query_evaluator{ context, _expression.query });
+        } else if (_evaluator->dynamic()) {
+            _evaluator->update();
+        }
+        auto& evaluator = *_evaluator;
+
+        auto collect = [&](compiler::resource& resource) {
+            // Evaluate the query this resource and collect if it matches
+            if (_collected.count(&resource) == 0 && evaluator.evaluate(resource)) {
+                _collected.insert(&resource);
+                collect_resource(context, resource, false);
+            }
+            return true;
+        };
+
+        // If the query requires the title or an attribute to equal a string, look up the matching resources directly
+        if (auto query = indexed_query()) {
+            if (auto str = evaluator.operand(*query).as<string>()) {
+                if (query->attribute.value == "title") {
+                    if (auto resource = catalog.find(runtime::types::resource{ _expression.type.name, *str })) {
+                        collect(*resource);
+                    }
+                } else {
+                    catalog.each_matching(collect, _expression.type.name, query->attribute.value, *str);
+                }
+                return;
+            }
+        }
 
-        // Realize each resource that matches the query
+        // Otherwise, evaluate the query against each resource added since the last collection
         catalog.each(
             [&](compiler::resource& resource) {
                 ++_index;
-
-                // Evaluate the query this resource and collect if it matches
-                if (evaluator.evaluate(resource)) {
-                    collect_resource(context, resource, false);
-                }
-                return true;
+                return collect(resource);
             },
             _expression.type.name,
             _index);
     }
 
+    ast::attribute_query const* query_collector::indexed_query() const
+    {
+        auto const& query = _expression.query;
+        if (!query) {
+            return nullptr;
+        }
+
+        // The primary term is only required to match if the remaining terms are joined with "and"
+        for (auto const& term : query->remainder) {
+            if (term.oper != ast::binary_query_operator::logical_and) {
+                return nullptr;
+            }
+        }
+
+        auto attribute = boost::get<ast::attribute_query>(&query->primary);
+        if (!attribute || attribute->oper != ast::attribute_query_operator::equals) {
+            return nullptr;
+        }
+        return attribute;
+    }
+
 }}}}  // namespace puppet::compiler::evaluation::collectors
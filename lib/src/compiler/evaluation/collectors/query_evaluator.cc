@@ -13,6 +13,9 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
         _context(context),
         _expression(expression)
     {
+        if (_expression) {
+            compile(*_expression);
+        }
     }
 
     bool query_evaluator::evaluate(compiler::resource const& resource) const
@@ -21,13 +24,63 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
         if (!_expression) {
             return true;
         }
+        return evaluate(*_expression, resource);
+    }
+
+    bool query_evaluator::dynamic() const
+    {
+        return !_dynamic.empty();
+    }
+
+    void query_evaluator::update()
+    {
+        evaluation::evaluator evaluator{ _context };
+        for (auto query : _dynamic) {
+            _operands[query] = evaluator.evaluate(query->value);
+        }
+    }
+
+    values::value const& query_evaluator::operand(ast::attribute_query const& query) const
+    {
+        auto it = _operands.find(&query);
+        if (it == _operands.end()) {
+            throw runtime_error("attribute query is not part of the query expression.");
+        }
+        return it->second;
+    }
+
+    void query_evaluator::compile(ast::collector_query_expression const& expression)
+    {
+        compile(expression.primary);
+        for (auto const& binary : expression.remainder) {
+            compile(binary.operand);
+        }
+    }
 
+    void query_evaluator::compile(ast::attribute_query_expression const& expression)
+    {
+        if (auto nested = boost::get<x3::forward_ast<ast::collector_query_expression>>(&expression)) {
+            compile(nested->get());
+            return;
+        }
+
+        auto& query = boost::get<ast::attribute_query>(expression);
+        if (!is_constant(query.value)) {
+            _dynamic.push_back(&query);
+        }
+
+        evaluation::evaluator evaluator{ _context };
+        _operands[&query] = evaluator.evaluate(query.value);
+    }
+
+    bool query_evaluator::evaluate(ast::collector_query_expression const& expression, compiler::resource const& resource) const
+    {
         // Evaluate the primary expression
-        auto result = evaluate(_expression->primary, resource);
+        auto result = evaluate(expression.primary, resource);
 
         // Climb the remainder of the expression
-        auto begin = _expression->remainder.begin();
-        climb_expression(result, 0, begin, _expression->remainder.end(), resource);
+        auto begin = expression.remainder.begin();
+        climb_expression(result, 0, begin, expression.remainder.end(), resource);
         return result;
     }
 
@@ -35,17 +88,14 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
     {
         // Handle nested expressions
         if (auto nested = boost::get<x3::forward_ast<ast::collector_query_expression>>(&expression)) {
-            query_evaluator evaluator{ _context, nested->get() };
-            return evaluator.evaluate(resource);
+            return evaluate(nested->get(), resource);
         }
 
-        evaluation::evaluator evaluator{ _context };
-
         // Otherwise, this should be an attribute query
         auto& query = boost::get<ast::attribute_query>(expression);
 
-        // Evaluate the expected value
-        auto expected = evaluator.evaluate(query.value);
+        // Get the expected value
+        auto const& expected = operand(query);
 
         // If the query is on the title, search the resource's title
         bool result = false;
@@ -137,4 +187,21 @@ namespace puppet { namespace compiler { namespace evaluation { namespace collect
         return false;
     }
 
+    bool query_evaluator::is_constant(ast::primary_expression const& expression)
+    {
+        // Literals cannot change; variables cannot be reassigned once set
+        if (auto str = boost::get<ast::string>(&expression)) {
+            return !str->interpolated;
+        }
+        return boost::get<ast::undef>(&expression) ||
+               boost::get<ast::defaulted>(&expression) ||
+               boost::get<ast::boolean>(&expression) ||
+               boost::get<ast::number>(&expression) ||
+               boost::get<ast::regex>(&expression) ||
+               boost::get<ast::variable>(&expression) ||
+               boost::get<ast::name>(&expression) ||
+               boost::get<ast::bare_word>(&expression) ||
+               boost::get<ast::type>(&expression);
+    }
+
 }}}}  // namespace puppet::compiler::evaluation::collectors
@@ -525,7 +525,7 @@ namespace puppet { namespace compiler { namespace evaluation {
         return resource;
     }
 
-    vector<klass> const* context::find_class(string name, bool import)
+    shared_ptr<vector<klass> const> context::find_class(string name, bool import)
     {
         // Ensure the name is in the expected format
         types::klass::normalize(name);
@@ -443,7 +443,7 @@ namespace puppet { namespace compiler { namespace evaluation {
 
         if (auto array = reference.as<values::array>()) {
             for (auto const& element : *array) {
-                if (auto type = element->as<values::type>()) {
+                if (auto type = element.as<values::type>()) {
                     auto resource = to_resource_type(*type, context);
                     if (!resource->fully_qualified()) {
                         // TODO: support resource defaults expression
@@ -451,7 +451,7 @@ namespace puppet { namespace compiler { namespace evaluation {
                     }
                     _context.add(resource_override(*resource, expression.context(), attributes, _context.current_scope()));
                 } else {
-                    throw evaluation_exception((boost::format("expected qualified %1% for array element but found %2%.") % types::resource::name() % element->get_type()).str(), context);
+                    throw evaluation_exception((boost::format("expected qualified %1% for array element but found %2%.") % types::resource::name() % element.get_type()).str(), context);
                 }
             }
         } else if (auto type = reference.as<values::type>()) {
@@ -580,6 +580,8 @@ namespace puppet { namespace compiler { namespace evaluation {
 
     attributes evaluator::evaluate_attributes(bool is_class, vector<ast::attribute> const& expressions)
     {
+        // Attributes live as long as the catalog, so allocate them from its arena
+        auto& arena = _context.catalog().arena();
         compiler::attributes attributes;
 
         unordered_set<std::string> names;
@@ -611,10 +613,10 @@ namespace puppet { namespace compiler { namespace evaluation {
             validate_attribute(name, value, expression.value.context());
 
             // Add an attribute to the list
-            attributes.emplace_back(make_pair(expression.oper, std::make_shared<attribute>(
+            attributes.emplace_back(make_pair(expression.oper, arena.make_shared<attribute>(
                 name,
                 expression.name.context,
-                std::make_shared<values::value>(rvalue_cast(value)),
+                arena.make_shared<values::value>(rvalue_cast(value)),
                 expression.value.context()
             )));
         }
@@ -623,6 +625,8 @@ namespace puppet { namespace compiler { namespace evaluation {
 
     void evaluator::splat_attribute(compiler::attributes& attributes, unordered_set<std::string>& names, ast::attribute const& attribute)
     {
+        auto& arena = _context.catalog().arena();
+
         // Evaluate what must be a hash
         auto value = evaluate(attribute.value);
         if (!value.as<values::hash>()) {
@@ -645,10 +649,10 @@ namespace puppet { namespace compiler { namespace evaluation {
             validate_attribute(*name, value, attribute.value.context());
 
             // Add the attribute to the list
-            attributes.emplace_back(make_pair(attribute.oper, std::make_shared<compiler::attribute>(
+            attributes.emplace_back(make_pair(attribute.oper, arena.make_shared<compiler::attribute>(
                 *name,
                 attribute.name.context,
-                std::make_shared<values::value>(rvalue_cast(value)),
+                arena.make_shared<values::value>(rvalue_cast(value)),
                 attribute.value.context()
             )));
         }
@@ -676,7 +680,7 @@ namespace puppet { namespace compiler { namespace evaluation {
             type = &string_array_type;
             if (!value.as<values::array>()) {
                 value = value.to_array(false);
-                original = &*value.as<values::array>()->at(0);
+                original = &value.as<values::array>()->at(0);
             }
         } else if (name == "audit") {
             type = &audit_type;
@@ -684,7 +688,7 @@ namespace puppet { namespace compiler { namespace evaluation {
             type = &relationship_type;
             if (!value.as<values::array>()) {
                 value = value.to_array(false);
-                original = &*value.as<values::array>()->at(0);
+                original = &value.as<values::array>()->at(0);
             }
         } else if (name == "loglevel") {
             type = &loglevel_type;
@@ -698,7 +702,7 @@ namespace puppet { namespace compiler { namespace evaluation {
             type = &string_array_type;
             if (!value.as<values::array>()) {
                 value = value.to_array(false);
-                original = &*value.as<values::array>()->at(0);
+                original = &value.as<values::array>()->at(0);
             }
         }
 
@@ -145,7 +145,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
 
         // Visit the argument and return it
         boost::apply_visitor(each_visitor(context), arguments[0]);
-        return rvalue_cast(*arguments[0]);
+        return rvalue_cast(arguments[0]);
     }
 
 }}}}  // namespace puppet::compiler::evaluation::functions
@@ -21,18 +21,18 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
             throw evaluation_exception((boost::format("expected 1 or 2 arguments to '%1%' function but %2% were given.") % context.name() % count).str(), count > 2 ? context.argument_context(2) : context.call_site());
         }
         // First argument should be a string
-        auto input = arguments[0]->as<string>();
+        auto input = arguments[0].as<string>();
         if (!input) {
-            throw evaluation_exception((boost::format("expected %1% for first argument but found %2%.") % types::string::name() % arguments[0]->get_type()).str(), context.argument_context(0));
+            throw evaluation_exception((boost::format("expected %1% for first argument but found %2%.") % types::string::name() % arguments[0].get_type()).str(), context.argument_context(0));
         }
         // Verify the template arguments if present
         values::hash template_arguments;
         if (count > 1) {
-            if (!arguments[1]->as<values::hash>()) {
-                throw evaluation_exception((boost::format("expected %1% for second argument but found %2%.") % types::hash::name() % arguments[1]->get_type()).str(), context.argument_context(1));
+            if (!arguments[1].as<values::hash>()) {
+                throw evaluation_exception((boost::format("expected %1% for second argument but found %2%.") % types::hash::name() % arguments[1].get_type()).str(), context.argument_context(1));
             }
 
-            template_arguments = arguments[1]->move_as<values::hash>();
+            template_arguments = arguments[1].move_as<values::hash>();
 
             // Ensure all keys are strings
             for (auto const& kvp : template_arguments) {
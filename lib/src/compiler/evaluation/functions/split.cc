@@ -52,8 +52,8 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
                 return split_empty(first);
             }
             values::array result;
-            std::regex pattern(regexp->pattern());
-            for (sregex_token_iterator begin{ first.begin(), first.end(), pattern, -1}, end; begin != end; ++begin) {
+            values::regex pattern(regexp->pattern());
+            for (sregex_token_iterator begin{ first.begin(), first.end(), pattern.value(), -1}, end; begin != end; ++begin) {
                 result.emplace_back(string(*begin));
             }
             return result;
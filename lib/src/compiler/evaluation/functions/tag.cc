@@ -26,7 +26,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
 
         // Add the tags to the resource
         for (size_t i = 0; i < arguments.size(); ++i) {
-            auto& argument = *arguments[i];
+            auto& argument = arguments[i];
             if (!argument.move_as<string>([&](string tag) {
                 resource->tag(rvalue_cast(tag));
                 return true;
@@ -24,14 +24,14 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
             return false;
         }
 
-        auto tags = resource->calculate_tags();
+        auto tags = resource->tags();
 
         // Make sure all given arguments are in the tag set
         for (size_t i = 0; i < arguments.size(); ++i) {
-            auto& argument = *arguments[i];
+            auto& argument = arguments[i];
             bool matches = true;
             if (!argument.move_as<string>([&](string tag) {
-                if (tags.find(&tag) == tags.end()) {
+                if (!tags->contains(tag)) {
                     matches = false;
                     return false;
                 }
@@ -19,13 +19,13 @@ namespace puppet { namespace compiler { namespace evaluation { namespace functio
         }
 
         // Both arguments should be Strings
-        auto version_a = arguments[0]->as<string>();
+        auto version_a = arguments[0].as<string>();
         if (!version_a) {
-            throw evaluation_exception((boost::format("expected %1% for first argument but found %2%.") % types::string::name() % arguments[0]->get_type()).str(), context.argument_context(0));
+            throw evaluation_exception((boost::format("expected %1% for first argument but found %2%.") % types::string::name() % arguments[0].get_type()).str(), context.argument_context(0));
         }
-        auto version_b = arguments[1]->as<string>();
+        auto version_b = arguments[1].as<string>();
         if (!version_b) {
-            throw evaluation_exception((boost::format("expected %1% for second argument but found %2%.") % types::string::name() % arguments[1]->get_type()).str(), context.argument_context(1));
+            throw evaluation_exception((boost::format("expected %1% for second argument but found %2%.") % types::string::name() % arguments[1].get_type()).str(), context.argument_context(1));
         }
 
         // The regex used to split the version numbers into sub-sections
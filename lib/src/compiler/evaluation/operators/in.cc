@@ -41,7 +41,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
         result_type operator()(values::regex const& left, values::array const& right) const
         {
             for (auto const& element : right) {
-                auto ptr = element->as<std::string>();
+                auto ptr = element.as<std::string>();
                 if (ptr && operator()(left, *ptr)) {
                     return true;
                 }
@@ -19,7 +19,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
         {
             try {
                 smatch matches;
-                bool result = right.empty() || regex_search(left, matches, std::regex(right));
+                bool result = right.empty() || regex_search(left, matches, values::regex(right).value());
                 _context.context().set(matches);
                 return result;
             } catch (regex_error const& ex) {
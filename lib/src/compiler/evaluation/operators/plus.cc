@@ -55,6 +55,14 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
 
         result_type operator()(values::array const& left, values::array const& right) const
         {
+            // Share the elements of the other operand when one is empty
+            if (right.empty()) {
+                return left;
+            }
+            if (left.empty()) {
+                return right;
+            }
+
             values::array result;
             result.reserve(left.size() + right.size());
             result.insert(result.end(), left.begin(), left.end());
@@ -93,6 +101,14 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
 
         result_type operator()(values::hash const& left, values::hash const& right) const
         {
+            // Share the elements of the other operand when one is empty
+            if (right.empty()) {
+                return left;
+            }
+            if (left.empty()) {
+                return right;
+            }
+
             // Create a copy of the left and add key-value pairs
             auto result = left;
             result.set(right.begin(), right.end());
@@ -104,7 +120,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
             // Check to see if the array is a "hash" (made up of one or two element arrays only)
             bool hash = true;
             for (auto const& element : right) {
-                auto subarray = element->as<values::array>();
+                auto subarray = element.as<values::array>();
                 if (!subarray || subarray->empty() || subarray->size() > 2) {
                     hash = false;
                     break;
@@ -114,7 +130,7 @@ namespace puppet { namespace compiler { namespace evaluation { namespace operato
             auto result = left;
             if (hash) {
                 for (auto& element : right) {
-                    if (auto ptr = element->as<values::array>()) {
+                    if (auto ptr = element.as<values::array>()) {
                         result.set((*ptr)[0], ptr->size() == 1 ? values::undef() : (*ptr)[1]);
                     }
                 }
@@ -98,4 +98,9 @@ namespace puppet { namespace compiler {
     {
     }
 
+    server_exception::server_exception(string const& message) :
+        runtime_error(message)
+    {
+    }
+
 }}  // namespace puppet::compiler
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <puppet/cast.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/filesystem.hpp>
+#include <algorithm>
+#include <vector>
 
 using namespace std;
 namespace fs = boost::filesystem;
@@ -10,7 +12,8 @@ namespace sys = boost::system;
 namespace puppet { namespace compiler {
 
     finder::finder(string directory) :
-        _directory(rvalue_cast(directory))
+        _directory(rvalue_cast(directory)),
+        _indexed(false)
     {
     }
 
@@ -25,6 +28,19 @@ namespace puppet { namespace compiler {
             return string();
         }
 
+        // Use the index if there is one; a name that is not in the index does not have a file
+        if (_indexed) {
+            switch (type) {
+                case find_type::manifest: {
+                    auto it = _manifests.find(name);
+                    return it == _manifests.end() ? string() : it->second;
+                }
+
+                default:
+                    throw runtime_error("unexpected file type.");
+            }
+        }
+
         fs::path path = _directory;
 
         switch (type) {
@@ -51,4 +67,77 @@ namespace puppet { namespace compiler {
         return path.string();
     }
 
+    void finder::index()
+    {
+        _manifests.clear();
+        _indexed = true;
+
+        auto directory = fs::path{ _directory } / "manifests";
+
+        sys::error_code ec;
+        if (!fs::is_directory(directory, ec) || ec) {
+            return;
+        }
+
+        // Track the canonical paths of the directories being iterated so that a symlink to an ancestor is not followed
+        vector<fs::path> ancestors{ fs::canonical(directory, ec) };
+        if (ec) {
+            return;
+        }
+
+        // Map each manifest's qualified name to its path (e.g. 'foo::bar' => '.../manifests/foo/bar.pp')
+        // Follow symlinked directories as module trees are often linked into place
+        fs::recursive_directory_iterator it{directory, fs::symlink_option::recurse, ec};
+        fs::recursive_directory_iterator end{};
+        for (; !ec && it != end; it.increment(ec)) {
+            auto const& path = it->path();
+            if (fs::is_directory(it->status())) {
+                ancestors.resize(it.level() + 1);
+                sys::error_code canonical_ec;
+                auto target = fs::canonical(path, canonical_ec);
+                if (canonical_ec || std::find(ancestors.begin(), ancestors.end(), target) != ancestors.end()) {
+                    it.no_push();
+                } else {
+                    ancestors.emplace_back(rvalue_cast(target));
+                }
+                continue;
+            }
+            if (path.extension() != ".pp" || !fs::is_regular_file(it->status())) {
+                continue;
+            }
+
+            // Skip past the components of the manifests directory
+            auto component = path.begin();
+            for (auto part = directory.begin(); part != directory.end(); ++part) {
+                ++component;
+            }
+
+            string name;
+            for (; component != path.end(); ++component) {
+                if (!name.empty()) {
+                    name += "::";
+                }
+                name += component->string();
+            }
+            name.erase(name.size() - path.extension().string().size());
+            _manifests.emplace(rvalue_cast(name), path.string());
+        }
+    }
+
+    void finder::each(find_type type, function<bool(string const&, string const&)> const& callback) const
+    {
+        switch (type) {
+            case find_type::manifest:
+                for (auto const& kvp : _manifests) {
+                    if (!callback(kvp.first, kvp.second)) {
+                        return;
+                    }
+                }
+                break;
+
+            default:
+                throw runtime_error("unexpected file type.");
+        }
+    }
+
 }}  // namespace puppet::compiler
@@ -98,16 +98,17 @@ namespace puppet { namespace compiler { namespace parser {
 
     shared_ptr<ast::syntax_tree> parse_file(std::string path, compiler::module const* module, bool epp)
     {
-        static file_static_lexer lexer;
-
-        ifstream input(path);
+        // Read the whole file rather than lexing through a buffered stream iterator; the contents are lexed in memory
+        // with the string lexer and are kept by the tree for error context
+        ifstream input(path, ios::binary);
         if (!input) {
             throw compilation_exception((boost::format("file '%1%' does not exist or cannot be read.") % path).str());
         }
-
-        auto tree = ast::syntax_tree::create(rvalue_cast(path), module);
-        parse(lexer, input, *tree, epp);
-        return tree;
+        std::string source{ istreambuf_iterator<char>(input), istreambuf_iterator<char>() };
+        if (input.bad()) {
+            throw compilation_exception((boost::format("file '%1%' does not exist or cannot be read.") % path).str());
+        }
+        return parse_string(rvalue_cast(source), rvalue_cast(path), module, epp);
     }
 
     shared_ptr<ast::syntax_tree> parse_string(std::string source, std::string path, compiler::module const* module, bool epp)
@@ -0,0 +1,345 @@
+#include <puppet/compiler/server.hpp>
+#include <puppet/compiler/node.hpp>
+#include <puppet/compiler/exceptions.hpp>
+#include <puppet/facts/yaml.hpp>
+#include <puppet/runtime/json_writer.hpp>
+#include <puppet/cast.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/format.hpp>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <streambuf>
+#include <csignal>
+#include <cerrno>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace puppet { namespace compiler {
+
+    static volatile sig_atomic_t interrupted = 0;
+
+    static void interrupt(int)
+    {
+        interrupted = 1;
+    }
+
+    // Stream buffer that writes to a socket descriptor
+    struct descriptor_buffer : streambuf
+    {
+        explicit descriptor_buffer(int descriptor) :
+            _descriptor(descriptor)
+        {
+            setp(_buffer, _buffer + sizeof(_buffer));
+        }
+
+        ~descriptor_buffer()
+        {
+            sync();
+        }
+
+     protected:
+        int_type overflow(int_type ch) override
+        {
+            if (!flush()) {
+                return traits_type::eof();
+            }
+            if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(ch);
+                pbump(1);
+            }
+            return traits_type::not_eof(ch);
+        }
+
+        int sync() override
+        {
+            return flush() ? 0 : -1;
+        }
+
+     private:
+        bool flush()
+        {
+            char const* data = pbase();
+            size_t remaining = pptr() - pbase();
+            while (remaining > 0) {
+                auto written = ::write(_descriptor, data, remaining);
+                if (written < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return false;
+                }
+                data += written;
+                remaining -= written;
+            }
+            setp(_buffer, _buffer + sizeof(_buffer));
+            return true;
+        }
+
+        int _descriptor;
+        char _buffer[64 * 1024];
+    };
+
+    // The number of seconds to wait for more of a request before giving up on the client
+    static const int request_timeout = 30;
+
+    static bool read_request(int descriptor, string& request)
+    {
+        timeval timeout = {};
+        timeout.tv_sec = request_timeout;
+        if (setsockopt(descriptor, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0) {
+            return false;
+        }
+
+        char buffer[64 * 1024];
+        while (true) {
+            auto count = ::read(descriptor, buffer, sizeof(buffer));
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            if (count == 0) {
+                return true;
+            }
+            request.append(buffer, count);
+        }
+    }
+
+    static void write_error(ostream& out, string const& message)
+    {
+        {
+            runtime::json_writer writer{out, false};
+            writer.start_object();
+            writer.key("error");
+            writer.string(message);
+            writer.end_object();
+        }
+        out << endl;
+    }
+
+    server::server(logging::logger& logger, shared_ptr<compiler::environment> environment, string path, size_t threads, bool compact) :
+        _logger(logger),
+        _environment(rvalue_cast(environment)),
+        _path(rvalue_cast(path)),
+        _descriptor(-1),
+        _compact(compact),
+        _compiling(0),
+        _refresh_pending(false),
+        _refreshing(false),
+        _refreshed(chrono::steady_clock::now()),
+        _scheduler(threads)
+    {
+    }
+
+    server::~server()
+    {
+        if (_descriptor >= 0) {
+            close(_descriptor);
+            unlink(_path.c_str());
+        }
+    }
+
+    string const& server::path() const
+    {
+        return _path;
+    }
+
+    void server::run()
+    {
+        auto& logger = _logger;
+
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (_path.size() >= sizeof(address.sun_path)) {
+            throw server_exception((boost::format("socket path '%1%' is too long.") % _path).str());
+        }
+        strncpy(address.sun_path, _path.c_str(), sizeof(address.sun_path) - 1);
+
+        _descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (_descriptor < 0) {
+            throw server_exception((boost::format("cannot create socket: %1%.") % strerror(errno)).str());
+        }
+
+        // Remove a stale socket file left behind by a previous server, but never any other kind of file
+        struct stat status;
+        if (lstat(_path.c_str(), &status) == 0) {
+            if (!S_ISSOCK(status.st_mode)) {
+                throw server_exception((boost::format("cannot listen on '%1%': the path exists and is not a socket.") % _path).str());
+            }
+            unlink(_path.c_str());
+        }
+
+        if (::bind(_descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(_descriptor, SOMAXCONN) < 0) {
+            throw server_exception((boost::format("cannot listen on '%1%': %2%.") % _path % strerror(errno)).str());
+        }
+
+        // Stop accepting on interrupt; clients that disconnect early should not terminate the server
+        struct sigaction action = {};
+        action.sa_handler = interrupt;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+        signal(SIGPIPE, SIG_IGN);
+
+        LOG(notice, "listening for compilation requests on '%1%' using %2% threads.", _path, _scheduler.threads());
+
+        while (!interrupted) {
+            int connection = accept(_descriptor, nullptr, nullptr);
+            if (connection < 0) {
+                if (errno == EINTR || errno == ECONNABORTED) {
+                    continue;
+                }
+                throw server_exception((boost::format("cannot accept connection on '%1%': %2%.") % _path % strerror(errno)).str());
+            }
+            refresh();
+            _scheduler.queue([this, connection]() {
+                try {
+                    handle(connection);
+                } catch (...) {
+                    close(connection);
+                    throw;
+                }
+                close(connection);
+            });
+        }
+
+        LOG(notice, "shutting down compile server.");
+        _scheduler.wait();
+    }
+
+    void server::refresh()
+    {
+        // Check for changed files at most once a second
+        lock_guard<mutex> lock{ _mutex };
+        if (_refresh_pending || _refreshing || chrono::steady_clock::now() - _refreshed < chrono::seconds(1)) {
+            return;
+        }
+
+        // Never wait for compilations here as that would stop the server from accepting connections
+        // Instead, mark the refresh as pending so that no new compilation starts; the next request refreshes once running compilations finish
+        _refresh_pending = true;
+    }
+
+    void server::start_compilation()
+    {
+        auto& logger = _logger;
+
+        unique_lock<mutex> lock{ _mutex };
+        while (true) {
+            if (!_refresh_pending && !_refreshing) {
+                ++_compiling;
+                return;
+            }
+
+            // In-progress compilations may be using definitions from changed files, so only refresh when none are running
+            if (_refresh_pending && !_refreshing && _compiling == 0) {
+                _refresh_pending = false;
+                _refreshing = true;
+                lock.unlock();
+                try {
+                    _environment->refresh(_logger);
+                } catch (exception const& ex) {
+                    LOG(error, "failed to refresh environment '%1%': %2%", _environment->name(), ex.what());
+                }
+                lock.lock();
+                _refreshing = false;
+                _refreshed = chrono::steady_clock::now();
+                _changed.notify_all();
+                continue;
+            }
+            _changed.wait(lock);
+        }
+    }
+
+    void server::finish_compilation()
+    {
+        lock_guard<mutex> lock{ _mutex };
+        if (--_compiling == 0) {
+            _changed.notify_all();
+        }
+    }
+
+    void server::handle(int descriptor)
+    {
+        auto& logger = _logger;
+
+        descriptor_buffer buffer{descriptor};
+        ostream output{&buffer};
+
+        // Read the request before locking so that a slow client cannot hold up a refresh
+        string request;
+        if (!read_request(descriptor, request)) {
+            LOG(error, "failed to read compilation request: %1%.", errno == EAGAIN || errno == EWOULDBLOCK ? "timed out" : strerror(errno));
+            return;
+        }
+
+        // Prevent the environment from being refreshed while compiling; waits for a pending refresh to complete first
+        start_compilation();
+        try {
+            compile(output, request);
+        } catch (...) {
+            finish_compilation();
+            throw;
+        }
+        finish_compilation();
+    }
+
+    void server::compile(ostream& output, string const& request)
+    {
+        auto& logger = _logger;
+        auto start = chrono::steady_clock::now();
+
+        // The first line is the node name; the remainder is the node's facts
+        auto newline = request.find('\n');
+        auto name = boost::trim_copy(request.substr(0, newline));
+        if (name.empty()) {
+            write_error(output, "expected a node name on the first line of the request.");
+            return;
+        }
+
+        shared_ptr<facts::provider> facts;
+        try {
+            istringstream stream{newline == string::npos ? string{} : request.substr(newline + 1)};
+            facts = make_shared<facts::yaml>(stream, name);
+        } catch (facts::yaml_parse_exception const& ex) {
+            LOG(error, ex.line(), ex.column(), ex.text(), ex.path(), "node '%1%': %2%", name, ex.what());
+            write_error(output, ex.what());
+            return;
+        }
+
+        node node{logger, name, _environment, rvalue_cast(facts)};
+        try {
+            LOG(info, "compiling for node '%1%' with environment '%2%'.", node.name(), _environment->name());
+
+            auto catalog = node.compile();
+            catalog.detect_cycles();
+            catalog.write(output, catalog_format::json, !_compact);
+            output.flush();
+        } catch (compilation_exception const& ex) {
+            LOG(error, ex.line(), ex.column(), ex.text(), ex.path(), "node '%1%': %2%", node.name(), ex.what());
+            write_error(output, ex.what());
+            return;
+        } catch (resource_cycle_exception const& ex) {
+            LOG(error, ex.what());
+            write_error(output, ex.what());
+            return;
+        } catch (exception const& ex) {
+            // Always reply so that the client is not left with a closed connection
+            LOG(error, "node '%1%': unexpected exception: %2%", node.name(), ex.what());
+            write_error(output, ex.what());
+            return;
+        }
+
+        LOG(debug, "compiled catalog for node '%1%' in %2%ms.",
+            node.name(),
+            chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count());
+    }
+
+}}  // namespace puppet::compiler
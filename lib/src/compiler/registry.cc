@@ -111,35 +111,126 @@ namespace puppet { namespace compiler {
 
     void registry::import(ast::syntax_tree const& tree)
     {
+        // Only one tree is scanned at a time; the scanner registers through the locking member functions
+        lock_guard<mutex> import_lock{ _import_mutex };
+
         // Ensure trees are only scanned once
-        if (_imported.count(&tree)) {
-            return;
+        {
+            shared_lock<shared_timed_mutex> lock{ _mutex };
+            if (_imported.count(&tree)) {
+                return;
+            }
         }
 
         compiler::scanner scanner{ *this };
         scanner.scan(tree);
 
         // Mark the tree as imported
+        unique_lock<shared_timed_mutex> lock{ _mutex };
         _imported.emplace(&tree);
     }
 
-    vector<klass> const* registry::find_class(string const& name) const
+    void registry::unregister(ast::syntax_tree const& tree)
     {
+        lock_guard<mutex> import_lock{ _import_mutex };
+        unique_lock<shared_timed_mutex> lock{ _mutex };
+
+        if (!_imported.erase(&tree)) {
+            return;
+        }
+
+        // Remove the class definitions from the tree
+        for (auto it = _classes.begin(); it != _classes.end();) {
+            auto from_tree = [&](klass const& definition) { return definition.expression().context.tree == &tree; };
+            if (none_of(it->second->begin(), it->second->end(), from_tree)) {
+                ++it;
+                continue;
+            }
+
+            // The definitions may be shared with a caller, so copy the remaining ones
+            auto definitions = make_shared<vector<klass>>();
+            for (auto const& definition : *it->second) {
+                if (!from_tree(definition)) {
+                    definitions->emplace_back(definition);
+                }
+            }
+            if (definitions->empty()) {
+                it = _classes.erase(it);
+                continue;
+            }
+            it->second = rvalue_cast(definitions);
+            ++it;
+        }
+
+        // Remove the defined types from the tree
+        for (auto it = _defined_types.begin(); it != _defined_types.end();) {
+            if (it->second.expression().context.tree == &tree) {
+                it = _defined_types.erase(it);
+                continue;
+            }
+            ++it;
+        }
+
+        // Remove the node definitions from the tree and remap the indexes of the remaining definitions
+        vector<boost::optional<size_t>> indexes(_nodes.size());
+        deque<node_definition> nodes;
+        for (size_t i = 0; i < _nodes.size(); ++i) {
+            if (_nodes[i].expression().context.tree == &tree) {
+                continue;
+            }
+            indexes[i] = nodes.size();
+            nodes.emplace_back(rvalue_cast(_nodes[i]));
+        }
+        if (nodes.size() == _nodes.size()) {
+            return;
+        }
+        _nodes = rvalue_cast(nodes);
+
+        for (auto it = _named_nodes.begin(); it != _named_nodes.end();) {
+            if (!indexes[it->second]) {
+                it = _named_nodes.erase(it);
+                continue;
+            }
+            it->second = *indexes[it->second];
+            ++it;
+        }
+        _regex_nodes.erase(
+            remove_if(_regex_nodes.begin(), _regex_nodes.end(), [&](pair<values::regex, size_t> const& node) { return !indexes[node.second]; }),
+            _regex_nodes.end());
+        for (auto& node : _regex_nodes) {
+            node.second = *indexes[node.second];
+        }
+        if (_default_node_index) {
+            _default_node_index = indexes[*_default_node_index];
+        }
+    }
+
+    shared_ptr<vector<klass> const> registry::find_class(string const& name) const
+    {
+        shared_lock<shared_timed_mutex> lock{ _mutex };
+
         auto it = _classes.find(name);
-        if (it == _classes.end() || it->second.empty()) {
+        if (it == _classes.end()) {
             return nullptr;
         }
-        return &it->second;
+        return it->second;
     }
 
     void registry::register_class(compiler::klass klass)
     {
+        unique_lock<shared_timed_mutex> lock{ _mutex };
+
+        // Callers may still be using the current definitions, so replace them rather than appending in place
         auto& definitions = _classes[klass.name()];
-        definitions.emplace_back(rvalue_cast(klass));
+        auto updated = definitions ? make_shared<vector<compiler::klass>>(*definitions) : make_shared<vector<compiler::klass>>();
+        updated->emplace_back(rvalue_cast(klass));
+        definitions = rvalue_cast(updated);
     }
 
     defined_type const* registry::find_defined_type(string const& name) const
     {
+        shared_lock<shared_timed_mutex> lock{ _mutex };
+
         auto it = _defined_types.find(name);
         if (it == _defined_types.end()) {
             return nullptr;
@@ -152,6 +243,8 @@ namespace puppet { namespace compiler {
         // Add the defined type
         auto name = type.name();
 
+        unique_lock<shared_timed_mutex> lock{ _mutex };
+
         auto result = _defined_types.emplace(rvalue_cast(name), rvalue_cast(type));
         if (result.second) {
             return nullptr;
@@ -161,6 +254,8 @@ namespace puppet { namespace compiler {
 
     std::pair<node_definition const*, std::string> registry::find_node(compiler::node const& node) const
     {
+        shared_lock<shared_timed_mutex> lock{ _mutex };
+
         // If there are no node definitions, do nothing
         if (_nodes.empty()) {
             return make_pair(nullptr, string());
@@ -199,6 +294,12 @@ namespace puppet { namespace compiler {
     }
 
     node_definition const* registry::find_node(ast::node_expression const& expression) const
+    {
+        shared_lock<shared_timed_mutex> lock{ _mutex };
+        return find_node_unlocked(expression);
+    }
+
+    node_definition const* registry::find_node_unlocked(ast::node_expression const& expression) const
     {
         for (auto const& hostname : expression.hostnames) {
             // Check for default node
@@ -231,8 +332,10 @@ namespace puppet { namespace compiler {
 
     node_definition const* registry::register_node(node_definition node)
     {
+        unique_lock<shared_timed_mutex> lock{ _mutex };
+
         // Check for a node that would conflict with the given one
-        if (auto existing = find_node(node.expression())) {
+        if (auto existing = find_node_unlocked(node.expression())) {
             return existing;
         }
 
@@ -2,7 +2,10 @@
 #include <puppet/compiler/catalog.hpp>
 #include <puppet/compiler/exceptions.hpp>
 #include <puppet/cast.hpp>
-#include <rapidjson/document.h>
+#include <puppet/runtime/data_writer.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <iterator>
 
 using namespace std;
 using namespace puppet::runtime;
@@ -10,9 +13,46 @@ using namespace puppet::runtime::values;
 
 namespace puppet { namespace compiler {
 
-    bool indirect_less::operator()(string const* left, string const* right) const
+    tag_set::tag_set(vector<string> tags, shared_ptr<tag_set const> parent) :
+        _tags(rvalue_cast(tags)),
+        _parent(rvalue_cast(parent)),
+        _flattened(false)
     {
-        return *left < *right;
+        sort(_tags.begin(), _tags.end());
+        _tags.erase(unique(_tags.begin(), _tags.end()), _tags.end());
+    }
+
+    shared_ptr<tag_set const> const& tag_set::parent() const
+    {
+        return _parent;
+    }
+
+    bool tag_set::contains(string const& tag) const
+    {
+        for (auto set = this; set; set = set->_parent.get()) {
+            auto it = lower_bound(set->_tags.begin(), set->_tags.end(), tag);
+            if (it != set->_tags.end() && *it == tag) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    vector<string> const& tag_set::all() const
+    {
+        if (_flattened) {
+            return _all;
+        }
+        if (!_parent) {
+            _all = _tags;
+        } else {
+            // Merge with the parent's tags; the parent's are computed once and shared by every contained resource
+            auto const& parent = _parent->all();
+            _all.reserve(_tags.size() + parent.size());
+            set_union(_tags.begin(), _tags.end(), parent.begin(), parent.end(), back_inserter(_all));
+        }
+        _flattened = true;
+        return _all;
     }
 
     types::resource const& resource::type() const
@@ -60,11 +100,11 @@ namespace puppet { namespace compiler {
 
     shared_ptr<attribute> resource::get(string const& name) const
     {
-        auto it = _attributes.find(name);
-        if (it == _attributes.end()) {
+        auto it = find(name);
+        if (it == _attributes.end() || (*it)->name() != name) {
             return nullptr;
         }
-        return it->second;
+        return *it;
     }
 
     void resource::set(shared_ptr<compiler::attribute> attribute)
@@ -73,7 +113,39 @@ namespace puppet { namespace compiler {
             return;
         }
 
-        _attributes[attribute->name()] = rvalue_cast(attribute);
+        if (attribute->name() == "tag") {
+            _tags_changed = true;
+        }
+        if (_catalog) {
+            _catalog->index(*this, *attribute);
+        }
+
+        // Undef values are not written, so they do not contribute to the digest
+        runtime::digest hash;
+        if (!attribute->value().is_undef()) {
+            digest_writer writer;
+            writer.key(attribute->name());
+            attribute->value().write(writer);
+            hash = writer.result();
+        }
+        auto previous = this->hash();
+
+        // Replace an existing attribute or insert in order
+        auto it = find(attribute->name());
+        auto offset = it - _attributes.begin();
+        if (it != _attributes.end() && (*it)->name() == attribute->name()) {
+            _attributes[offset] = rvalue_cast(attribute);
+            _attributes_hash -= _attribute_hashes[offset];
+            _attribute_hashes[offset] = hash;
+        } else {
+            _attributes.insert(it, rvalue_cast(attribute));
+            _attribute_hashes.insert(_attribute_hashes.begin() + offset, hash);
+        }
+        _attributes_hash += hash;
+
+        if (_catalog && !virtualized()) {
+            _catalog->rehash(previous, this->hash());
+        }
     }
 
     bool resource::append(shared_ptr<compiler::attribute> attribute)
@@ -82,24 +154,24 @@ namespace puppet { namespace compiler {
             return true;
         }
 
-        auto it = _attributes.find(attribute->name());
-        if (it == _attributes.end()) {
+        auto previous = get(attribute->name());
+        if (!previous) {
             // Not present, just set
             set(rvalue_cast(attribute));
             return true;
         }
 
         // Ensure the existing value is an array
-        if (!it->second->value().as<values::array>()) {
+        if (!previous->value().as<values::array>()) {
             return false;
         }
 
         // If the attribute owns the value (is unique), modify it; otherwise copy it as it is shared
         values::array existing;
-        if (it->second->unique()) {
-            existing = it->second->value().move_as<values::array>();
+        if (previous->unique()) {
+            existing = previous->value().move_as<values::array>();
         } else {
-            existing = *it->second->value().as<values::array>();
+            existing = *previous->value().as<values::array>();
         }
 
         // Append the value to the array
@@ -172,8 +244,8 @@ namespace puppet { namespace compiler {
             return;
         }
 
-        for (auto const& kvp : _attributes) {
-            if (!callback(*kvp.second)) {
+        for (auto const& attribute : _attributes) {
+            if (!callback(*attribute)) {
                 break;
             }
         }
@@ -182,14 +254,56 @@ namespace puppet { namespace compiler {
     void resource::tag(string tag)
     {
         boost::to_lower(tag);
-        _tags.emplace_back(rvalue_cast(tag));
+
+        auto previous = hash();
+        if (!add_tag(rvalue_cast(tag))) {
+            return;
+        }
+        if (_catalog && !virtualized()) {
+            _catalog->rehash(previous, hash());
+        }
+    }
+
+    shared_ptr<tag_set const> resource::tags() const
+    {
+        // Reuse the cached set if neither this resource's tags nor its container's tag set have changed
+        auto parent = _container ? _container->tags() : nullptr;
+        if (_tag_set && !_tags_changed && _tag_set->parent() == parent) {
+            return _tag_set;
+        }
+
+        // Start with what is in the tags list
+        auto tags = _tags;
+
+        // Next add what is in the tag metaparameter
+        if (auto attribute = get("tag")) {
+            if (auto array = attribute->value().as<values::array>()) {
+                for (auto const& element : *array) {
+                    if (auto tag = element.as<string>()) {
+                        tags.emplace_back(*tag);
+                    }
+                }
+            }
+        }
+
+        _tag_set = make_shared<tag_set const>(rvalue_cast(tags), rvalue_cast(parent));
+        _tags_changed = false;
+        return _tag_set;
     }
 
-    tag_set resource::calculate_tags() const
+    runtime::digest resource::hash() const
     {
-        tag_set tags;
-        populate_tags(tags);
-        return tags;
+        digest_writer writer;
+        writer.string(_type.type_name());
+        writer.string(_type.title());
+        writer.string(path());
+        writer.number(static_cast<int64_t>(line()));
+        writer.boolean(_exported);
+        writer.number(static_cast<int64_t>(_tags_hash.high()));
+        writer.number(static_cast<int64_t>(_tags_hash.low()));
+        writer.number(static_cast<int64_t>(_attributes_hash.high()));
+        writer.number(static_cast<int64_t>(_attributes_hash.low()));
+        return writer.result();
     }
 
     bool resource::is_metaparameter(string const& name)
@@ -210,11 +324,13 @@ namespace puppet { namespace compiler {
         return metaparameters.count(name) > 0;
     }
 
-    resource::resource(types::resource type, resource const* container, ast::context const* context, bool exported) :
+    resource::resource(compiler::catalog* catalog, types::resource type, resource const* container, ast::context const* context, bool exported) :
+        _catalog(catalog),
         _type(rvalue_cast(type)),
         _container(container),
         _context(context),
         _vertex_id(numeric_limits<size_t>::max()),
+        _tags_changed(false),
         _exported(exported)
     {
         if (_container && _type.is_stage()) {
@@ -225,42 +341,48 @@ namespace puppet { namespace compiler {
         }
     }
 
-    json_value resource::to_json(json_allocator& allocator, compiler::catalog const& catalog) const
+    void resource::write(data_writer& writer, compiler::catalog const& catalog) const
     {
-        json_value value;
-        value.SetObject();
-
-        auto& type_name = _type.type_name();
-        auto& title = _type.title();
+        writer.start_object();
 
         // Write out the type and title
-        value.AddMember("type", rapidjson::StringRef(type_name.c_str(), type_name.size()), allocator);
-        value.AddMember("title", rapidjson::StringRef(title.c_str(), title.size()), allocator);
+        writer.key("type");
+        writer.string(_type.type_name());
+        writer.key("title");
+        writer.string(_type.title());
 
         // Write out the tags
-        auto tags = calculate_tags();
-        json_value tags_array;
-        tags_array.SetArray();
-        for (auto& tag : tags) {
-            tags_array.PushBack(json_value(rapidjson::StringRef(tag->c_str()), tag->size()), allocator);
+        writer.key("tags");
+        writer.start_array();
+        for (auto& tag : tags()->all()) {
+            writer.string(tag);
         }
-        value.AddMember("tags", rvalue_cast(tags_array), allocator);
+        writer.end_array();
 
         // Write out the file and line
         if (_context) {
-            value.AddMember("file", rapidjson::StringRef(_context->tree->path().c_str(), _context->tree->path().size()), allocator);
-            value.AddMember("line", static_cast<uint64_t>(line()), allocator);
+            writer.key("file");
+            writer.string(_context->tree->path());
+            writer.key("line");
+            writer.number(static_cast<int64_t>(line()));
         }
 
         // Write out whether or not the resource is exported
-        value.AddMember("exported", _exported, allocator);
-
-        // Write out the parameters
-        json_value parameters;
-        parameters.SetObject();
+        writer.key("exported");
+        writer.boolean(_exported);
+
+        // Write out the parameters; the object is only started once there is a parameter to write
+        bool started = false;
+        auto start = [&]() {
+            if (!started) {
+                writer.key("parameters");
+                writer.start_object();
+                started = true;
+            }
+        };
         for (auto& attribute : _attributes) {
-            auto const& name = attribute.first;
-            auto const& value = attribute.second->value();
+            auto const& name = attribute->name();
+            auto const& value = attribute->value();
 
             // Do not write any values set to undef
             if (value.is_undef()) {
@@ -272,58 +394,55 @@ namespace puppet { namespace compiler {
                 continue;
             }
 
-            parameters.AddMember(
-                rapidjson::StringRef(name.c_str(), name.size()),
-                value.to_json(allocator),
-                allocator);
-        }
-
-        // Add the relationship parameters
-        add_relationship_parameters(parameters, allocator, catalog);
-
-        if (parameters.MemberCount() > 0) {
-            value.AddMember("parameters", rvalue_cast(parameters), allocator);
+            start();
+            writer.key(name);
+            value.write(writer);
         }
-        return value;
-    }
-
-    void resource::add_relationship_parameters(json_value& parameters, json_allocator& allocator, compiler::catalog const& catalog) const
-    {
-        json_value require_parameter;
-        json_value subscribe_parameter;
-
-        require_parameter.SetArray();
-        subscribe_parameter.SetArray();
 
+        // Write the relationship parameters
+        // Since the edges represent those resources this resource depends on, treat before as require and notify as subscribe
+        vector<resource const*> require;
+        vector<resource const*> subscribe;
         catalog.each_edge(*this, [&](relationship relation, resource const& target) {
             // Ignore containment edges; those are handled by the catalog
             if (relation == relationship::contains) {
                 return true;
             }
-
-            // Since the edges represent those resources this resource depends on, treat before as require and notify as subscribe
-            json_value* parameter = nullptr;
             if (relation == relationship::before || relation == relationship::require) {
-                parameter = &require_parameter;
+                require.push_back(&target);
             } else if (relation == relationship::notify || relation == relationship::subscribe) {
-                parameter = &subscribe_parameter;
-            }
-
-            if (!parameter) {
+                subscribe.push_back(&target);
+            } else {
                 throw runtime_error("unexpected relationship.");
             }
-
-            // Add the target to the parameter
-            parameter->PushBack(json_value(boost::lexical_cast<string>(target.type()).c_str(), allocator), allocator);
             return true;
         });
+        auto write_targets = [&](char const* name, vector<resource const*> const& targets) {
+            if (targets.empty()) {
+                return;
+            }
+            start();
+            writer.key(name);
+            writer.start_array();
+            for (auto target : targets) {
+                writer.string(boost::lexical_cast<string>(target->type()));
+            }
+            writer.end_array();
+        };
+        write_targets("require", require);
+        write_targets("subscribe", subscribe);
 
-        if (require_parameter.Size() > 0) {
-            parameters.AddMember("require", rvalue_cast(require_parameter), allocator);
-        }
-        if (subscribe_parameter.Size() > 0) {
-            parameters.AddMember("subscribe", rvalue_cast(subscribe_parameter), allocator);
+        if (started) {
+            writer.end_object();
         }
+        writer.end_object();
+    }
+
+    vector<shared_ptr<attribute>>::const_iterator resource::find(string const& name) const
+    {
+        return lower_bound(_attributes.begin(), _attributes.end(), name, [](shared_ptr<attribute> const& attribute, string const& name) {
+            return attribute->name() < name;
+        });
     }
 
     void resource::realize(size_t vertex_id)
@@ -335,7 +454,7 @@ namespace puppet { namespace compiler {
 
         // Perform auto tagging
         if (is_class) {
-            _tags.emplace_back("class");
+            add_tag("class");
         }
 
         auto name = boost::to_lower_copy(is_class ? _type.title() : _type.type_name());
@@ -345,13 +464,13 @@ namespace puppet { namespace compiler {
             if (!*it) {
                 continue;
             }
-            _tags.emplace_back(it->begin(), it->end());
+            add_tag(string{ it->begin(), it->end() });
             ++parts;
         }
 
         // If the name had more than one part, add the entire name too (otherwise it was already added)
         if (parts > 1) {
-            _tags.emplace_back(rvalue_cast(name));
+            add_tag(rvalue_cast(name));
         }
     }
 
@@ -360,31 +479,18 @@ namespace puppet { namespace compiler {
         return _vertex_id;
     }
 
-    void resource::populate_tags(tag_set& tags) const
+    bool resource::add_tag(string tag)
     {
-        // First add what is in the tags list
-        for (auto const& tag : _tags) {
-            tags.insert(&tag);
-        }
-
-        // Next add what is in the tag metaparameter
-        auto attribute = get("tag");
-        if (attribute) {
-            if (auto array = attribute->value().as<values::array>()) {
-                for (auto const& element : *array) {
-                    if (auto tag = element->as<string>()) {
-                        tags.insert(tag);
-                    }
-                }
-            }
+        if (std::find(_tags.begin(), _tags.end(), tag) != _tags.end()) {
+            return false;
         }
 
-        // If there's a container, add its tags
-        // REVISIT: it would be far more efficient not to have to duplicate these at every resource, but that
-        //          requires catalog format improvements
-        if (_container) {
-            _container->populate_tags(tags);
-        }
+        digest_writer writer;
+        writer.string(tag);
+        _tags_hash += writer.result();
+        _tags.emplace_back(rvalue_cast(tag));
+        _tags_changed = true;
+        return true;
     }
 
 }}  // namespace puppet::compiler
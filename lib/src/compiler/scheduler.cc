@@ -0,0 +1,143 @@
+#include <puppet/compiler/scheduler.hpp>
+#include <puppet/cast.hpp>
+
+using namespace std;
+
+namespace puppet { namespace compiler {
+
+    scheduler::scheduler(size_t threads) :
+        _queued(0),
+        _pending(0),
+        _next(0),
+        _stopping(false)
+    {
+        if (threads == 0) {
+            threads = max(thread::hardware_concurrency(), 1u);
+        }
+
+        // Create the queues before starting any workers as workers steal from every queue
+        for (size_t i = 0; i < threads; ++i) {
+            _queues.emplace_back(make_unique<work_queue>());
+        }
+        for (size_t i = 0; i < threads; ++i) {
+            _threads.emplace_back(&scheduler::run, this, i);
+        }
+    }
+
+    scheduler::~scheduler()
+    {
+        {
+            unique_lock<mutex> lock{ _mutex };
+            _finished.wait(lock, [&]() { return _pending == 0; });
+            _stopping = true;
+        }
+        _available.notify_all();
+
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    size_t scheduler::threads() const
+    {
+        return _threads.size();
+    }
+
+    void scheduler::queue(function<void()> task)
+    {
+        if (!task) {
+            return;
+        }
+
+        size_t index;
+        {
+            lock_guard<mutex> lock{ _mutex };
+            ++_pending;
+            ++_queued;
+            index = _next++ % _queues.size();
+        }
+
+        // Distribute tasks round-robin; workers that run out of work will steal from the others
+        {
+            auto& queue = *_queues[index];
+            lock_guard<mutex> lock{ queue.mutex };
+            queue.tasks.emplace_back(rvalue_cast(task));
+        }
+        _available.notify_one();
+    }
+
+    void scheduler::wait()
+    {
+        unique_lock<mutex> lock{ _mutex };
+        _finished.wait(lock, [&]() { return _pending == 0; });
+
+        if (_exception) {
+            auto exception = _exception;
+            _exception = nullptr;
+            rethrow_exception(exception);
+        }
+    }
+
+    void scheduler::run(size_t index)
+    {
+        function<void()> task;
+        while (true) {
+            if (!take(index, task)) {
+                unique_lock<mutex> lock{ _mutex };
+                _available.wait(lock, [&]() { return _stopping || _queued > 0; });
+                if (_stopping && _queued == 0) {
+                    return;
+                }
+                continue;
+            }
+
+            try {
+                task();
+            } catch (...) {
+                lock_guard<mutex> lock{ _mutex };
+                if (!_exception) {
+                    _exception = current_exception();
+                }
+            }
+            task = nullptr;
+
+            bool finished = false;
+            {
+                lock_guard<mutex> lock{ _mutex };
+                finished = --_pending == 0;
+            }
+            if (finished) {
+                _finished.notify_all();
+            }
+        }
+    }
+
+    bool scheduler::take(size_t index, function<void()>& task)
+    {
+        // Take the most recently queued task from our own queue first
+        {
+            auto& queue = *_queues[index];
+            lock_guard<mutex> lock{ queue.mutex };
+            if (!queue.tasks.empty()) {
+                task = rvalue_cast(queue.tasks.back());
+                queue.tasks.pop_back();
+                --_queued;
+                return true;
+            }
+        }
+
+        // Otherwise, steal the oldest task from another worker's queue
+        for (size_t i = 1; i < _queues.size(); ++i) {
+            auto& queue = *_queues[(index + i) % _queues.size()];
+            lock_guard<mutex> lock{ queue.mutex };
+            if (!queue.tasks.empty()) {
+                task = rvalue_cast(queue.tasks.front());
+                queue.tasks.pop_front();
+                --_queued;
+                return true;
+            }
+        }
+        return false;
+    }
+
+}}  // namespace puppet::compiler
@@ -1,4 +1,5 @@
 #include <puppet/compiler/settings.hpp>
+#include <puppet/compiler/catalog.hpp>
 #include <puppet/compiler/exceptions.hpp>
 #include <puppet/facts/facter.hpp>
 #include <puppet/facts/yaml.hpp>
@@ -11,6 +12,7 @@
 #include <boost/program_options.hpp>
 #pragma GCC diagnostic pop
 #include <iostream>
+#include <thread>
 
 using namespace std;
 using namespace puppet::runtime::values;
@@ -26,6 +28,11 @@ namespace puppet { namespace compiler {
         // Keep this list sorted alphabetically based on each option's long-form name
         po::options_description options("");
         options.add_options()
+            (
+                "ast-cache",
+                po::value<string>(),
+                "The directory to cache parsed manifests in to speed up subsequent compilations."
+            )
             (
                 "code-dir",
                 po::value<string>(),
@@ -35,6 +42,10 @@ namespace puppet { namespace compiler {
                 "color",
                 "Forces color output on platforms that support colorized output."
             )
+            (
+                "compact",
+                "Write compiled catalogs as compact rather than indented JSON."
+            )
             (
                 "debug,d",
                 "Enable debug output."
@@ -54,6 +65,11 @@ namespace puppet { namespace compiler {
                 po::value<string>(),
                 "The path to the YAML facts file to use. Defaults to the current system's facts."
             )
+            (
+                "format",
+                po::value<string>()->default_value("json"),
+                "The format to write compiled catalogs in: json or cbor."
+            )
             (
                 "graph,g",
                 po::value<string>(),
@@ -63,6 +79,16 @@ namespace puppet { namespace compiler {
                 "help",
                 "Print this help message."
             )
+            (
+                "jobs,j",
+                po::value<size_t>(),
+                "The number of nodes to compile concurrently when using --nodes-from or --listen. Defaults to the number of hardware threads."
+            )
+            (
+                "listen",
+                po::value<string>(),
+                "The path of a local socket to listen on for compilation requests."
+            )
             (
                 "log-level,l",
                 po::value<logging::level>()->default_value(logging::level::notice, "notice"),
@@ -78,6 +104,11 @@ namespace puppet { namespace compiler {
                 po::value<string>(),
                 "The node name to use. Defaults to the 'fqdn' fact."
             )
+            (
+                "nodes-from",
+                po::value<string>(),
+                "The directory of YAML facts files (e.g. 'foo.example.com.yaml') to compile a catalog for each node."
+            )
             (
                 "no-color",
                 "Disables color output."
@@ -87,6 +118,18 @@ namespace puppet { namespace compiler {
                 po::value<string>()->default_value("catalog.json"),
                 "The output path for the compiled catalog."
             )
+            (
+                "output-dir",
+                po::value<string>(),
+                "The output directory for compiled catalogs when using --nodes-from. Defaults to the current directory."
+            )
+            (
+                "previous",
+                po::value<string>(),
+                "The path to the node's previously compiled catalog; the changes since that catalog are also written next to the "
+                "catalog (e.g. 'catalog.changes.json'). "
+                "When using --nodes-from, the directory containing the previously compiled catalogs."
+            )
             (
                 "verbose",
                 "Enable verbose (info) output."
@@ -119,6 +162,26 @@ namespace puppet { namespace compiler {
         return vm["log-level"].as<logging::level>();
     }
 
+    static string get_ast_cache_directory(po::variables_map const& vm)
+    {
+        if (!vm.count("ast-cache")) {
+            return {};
+        }
+
+        // Create the cache directory if it does not exist
+        auto directory = vm["ast-cache"].as<string>();
+
+        sys::error_code ec;
+        fs::create_directories(directory, ec);
+        if (!ec) {
+            auto path = fs::canonical(directory, ec);
+            if (!ec) {
+                return path.string();
+            }
+        }
+        throw settings_exception((boost::format("invalid AST cache directory '%1%': %2%.") % directory % ec.message()).str());
+    }
+
     static string get_code_directory(po::variables_map const& vm)
     {
         string directory;
@@ -171,7 +234,7 @@ namespace puppet { namespace compiler {
         auto networking = facts.lookup("networking");
         if (networking) {
             if (auto hash = networking->as<runtime::values::hash>()) {
-                auto fqdn = hash->get("fqdn");
+                auto fqdn = hash->get(string("fqdn"));
                 if (fqdn) {
                     if (auto str = fqdn->as<string>()) {
                         name = *str;
@@ -179,13 +242,13 @@ namespace puppet { namespace compiler {
                 }
                 // Fallback to the hostname and domain if present
                 if (name.empty()) {
-                    auto hostname = hash->get("hostname");
+                    auto hostname = hash->get(string("hostname"));
                     if (hostname) {
                         if (auto str = hostname->as<string>()) {
                             name = *str;
                         }
                         if (!name.empty()) {
-                            auto domain = hash->get("domain");
+                            auto domain = hash->get(string("domain"));
                             if (domain) {
                                 if (auto str = domain->as<string>()) {
                                     name += "." + *str;
@@ -244,6 +307,76 @@ namespace puppet { namespace compiler {
         return manifests;
     }
 
+    static string get_nodes_directory(po::variables_map const& vm)
+    {
+        if (!vm.count("nodes-from")) {
+            return {};
+        }
+
+        // Check for conflicting options
+        if (vm.count("facts")) {
+            throw settings_exception("nodes-from and facts options conflict: please specify only one.");
+        }
+        if (vm.count("node")) {
+            throw settings_exception("nodes-from and node options conflict: please specify only one.");
+        }
+        if (vm.count("graph")) {
+            throw settings_exception("nodes-from and graph options conflict: please specify only one.");
+        }
+        if (!vm["output"].defaulted()) {
+            throw settings_exception("nodes-from and output options conflict: please use output-dir to specify where catalogs are written.");
+        }
+
+        auto directory = vm["nodes-from"].as<string>();
+
+        sys::error_code ec;
+        auto path = fs::canonical(directory, ec);
+        if (ec || !fs::is_directory(path, ec)) {
+            throw settings_exception((boost::format("invalid nodes directory '%1%': %2%.") % directory % (ec ? ec.message() : "not a directory")).str());
+        }
+        return path.string();
+    }
+
+    static string get_socket_path(po::variables_map const& vm)
+    {
+        if (!vm.count("listen")) {
+            return {};
+        }
+
+        // Check for conflicting options
+        if (vm.count("nodes-from")) {
+            throw settings_exception("listen and nodes-from options conflict: please specify only one.");
+        }
+        if (vm.count("facts")) {
+            throw settings_exception("listen and facts options conflict: please specify only one.");
+        }
+        if (vm.count("node")) {
+            throw settings_exception("listen and node options conflict: please specify only one.");
+        }
+        if (vm.count("graph")) {
+            throw settings_exception("listen and graph options conflict: please specify only one.");
+        }
+        if (vm.count("previous")) {
+            throw settings_exception("listen and previous options conflict: please specify only one.");
+        }
+        if (vm["format"].as<string>() != "json") {
+            throw settings_exception("listen and format options conflict: catalogs are always written as JSON when using listen.");
+        }
+        return fs::absolute(vm["listen"].as<string>()).string();
+    }
+
+    static size_t get_jobs(po::variables_map const& vm)
+    {
+        if (vm.count("jobs")) {
+            auto jobs = vm["jobs"].as<size_t>();
+            if (jobs == 0) {
+                throw settings_exception("jobs option must be greater than zero.");
+            }
+            return jobs;
+        }
+        return max(thread::hardware_concurrency(), 1u);
+    }
+
     static string get_output_file(po::variables_map const& vm)
     {
         if (vm.count("output")) {
@@ -252,6 +385,42 @@ namespace puppet { namespace compiler {
         return {};
     }
 
+    static string get_output_directory(po::variables_map const& vm)
+    {
+        if (!vm.count("output-dir")) {
+            return {};
+        }
+
+        auto directory = vm["output-dir"].as<string>();
+
+        sys::error_code ec;
+        auto path = fs::canonical(directory, ec);
+        if (ec || !fs::is_directory(path, ec)) {
+            throw settings_exception((boost::format("invalid output directory '%1%': %2%.") % directory % (ec ? ec.message() : "not a directory")).str());
+        }
+        return path.string();
+    }
+
+    static catalog_format get_output_format(po::variables_map const& vm)
+    {
+        auto format = vm["format"].as<string>();
+        if (format == "json") {
+            return catalog_format::json;
+        }
+        if (format == "cbor") {
+            return catalog_format::cbor;
+        }
+        throw settings_exception((boost::format("invalid output format '%1%': expected json or cbor.") % format).str());
+    }
+
+    static string get_previous_path(po::variables_map const& vm)
+    {
+        if (vm.count("previous")) {
+            return vm["previous"].as<string>();
+        }
+        return {};
+    }
+
     static string get_graph_file(po::variables_map const& vm)
     {
         if (vm.count("graph")) {
@@ -330,6 +499,9 @@ namespace puppet { namespace compiler {
     }
 
     settings::settings() :
+        _jobs(1),
+        _output_format(catalog_format::json),
+        _compact_output(false),
         _log_level(logging::level::notice),
         _show_help(false),
         _show_version(false)
@@ -339,6 +511,9 @@ namespace puppet { namespace compiler {
     }
 
     settings::settings(int argc, char const* argv[]) :
+        _jobs(1),
+        _output_format(catalog_format::json),
+        _compact_output(false),
         _log_level(logging::level::notice),
         _show_help(false),
         _show_version(false)
@@ -346,6 +521,11 @@ namespace puppet { namespace compiler {
         parse(argc, argv);
     }
 
+    string const& settings::ast_cache_directory() const
+    {
+        return _ast_cache_directory;
+    }
+
     string const& settings::code_directory() const
     {
         return _code_directory;
@@ -376,11 +556,46 @@ namespace puppet { namespace compiler {
         return _node_name;
     }
 
+    string const& settings::nodes_directory() const
+    {
+        return _nodes_directory;
+    }
+
+    string const& settings::socket_path() const
+    {
+        return _socket_path;
+    }
+
+    size_t settings::jobs() const
+    {
+        return _jobs;
+    }
+
     string const& settings::output_file() const
     {
         return _output_file;
     }
 
+    string const& settings::output_directory() const
+    {
+        return _output_directory;
+    }
+
+    string const& settings::previous_path() const
+    {
+        return _previous_path;
+    }
+
+    catalog_format settings::output_format() const
+    {
+        return _output_format;
+    }
+
+    bool settings::compact_output() const
+    {
+        return _compact_output;
+    }
+
     string const& settings::graph_file() const
     {
         return _graph_file;
@@ -430,11 +645,24 @@ namespace puppet { namespace compiler {
             "\n"
             "Manifests will be evaluated in the order they are presented on the command line.\n"
             "\n"
+            "When --nodes-from is given, the environment is loaded once and a catalog is compiled\n"
+            "for each YAML facts file in the directory. The node name is the file name without\n"
+            "the extension and each catalog is written to '<node>.json' in the output directory\n"
+            "(or '<node>.cbor' when using --format cbor).\n"
+            "Nodes are compiled concurrently; use --jobs to limit the number of threads.\n"
+            "\n"
+            "When --listen is given, the environment is loaded once and the compiler waits for\n"
+            "requests on the given local socket. Each request is the node name on the first line\n"
+            "followed by the node's facts in YAML; the compiled catalog is written back as JSON.\n"
+            "The --format and --previous options cannot be used with --listen.\n"
+            "\n"
             "Examples\n"
             "========\n\n"
             "  puppetcpp\n"
             "  puppetcpp manifest.pp\n"
-            "  puppetcpp -e test -f facts.yaml"
+            "  puppetcpp -e test -f facts.yaml\n"
+            "  puppetcpp --nodes-from /var/facts --output-dir catalogs\n"
+            "  puppetcpp --listen /var/run/puppetcpp.sock"
             << endl;
     }
 
@@ -487,6 +715,9 @@ namespace puppet { namespace compiler {
         // Populate the logging level
         _log_level = get_level(vm);
 
+        // Populate the AST cache directory
+        _ast_cache_directory = get_ast_cache_directory(vm);
+
         // Populate the code directory
         _code_directory = get_code_directory(vm);
 
@@ -499,17 +730,39 @@ namespace puppet { namespace compiler {
         // Populate the module directories
         _module_directories = get_module_directories(vm, _code_directory);
 
-        // Populate the facts provider
-        _facts = get_facts(vm);
+        // Populate the nodes directory
+        _nodes_directory = get_nodes_directory(vm);
+
+        // Populate the socket path
+        _socket_path = get_socket_path(vm);
+
+        // Populate the number of concurrent jobs
+        _jobs = get_jobs(vm);
 
         // Populate the output file
         _output_file = get_output_file(vm);
 
+        // Populate the output directory
+        _output_directory = get_output_directory(vm);
+
+        // Populate the previous catalog path
+        _previous_path = get_previous_path(vm);
+
+        // Populate the output format
+        _output_format = get_output_format(vm);
+        _compact_output = vm.count("compact") > 0;
+
         // Populate the graph file
         _graph_file = get_graph_file(vm);
 
-        // Populate the node name
-        _node_name = get_node(vm, *_facts);
+        // When compiling from a nodes directory or on request, the facts and name are given per node
+        if (_nodes_directory.empty() && _socket_path.empty()) {
+            // Populate the facts provider
+            _facts = get_facts(vm);
+
+            // Populate the node name
+            _node_name = get_node(vm, *_facts);
+        }
 
         // Populate the manifests to compile
         _manifests = get_manifests(vm);
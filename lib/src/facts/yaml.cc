@@ -62,6 +62,23 @@ namespace puppet { namespace facts {
         }
     }
 
+    yaml::yaml(istream& stream, string const& path)
+    {
+        // Read the entire input so that the text of a parse error can be reported
+        string source{ istreambuf_iterator<char>(stream), istreambuf_iterator<char>() };
+        try {
+            Node node = YAML::Load(source);
+            for (auto const& kvp : node) {
+                store(kvp.first.as<string>(), kvp.second);
+            }
+        } catch (Exception& ex) {
+            string text;
+            size_t column;
+            tie(text, column) = get_text_and_column(source, ex.mark.pos);
+            throw yaml_parse_exception((boost::format("failed parsing facts: %1%.") % ex.msg).str(), path, ex.mark.line + 1, column, rvalue_cast(text));
+        }
+    }
+
     shared_ptr<values::value const> yaml::lookup(string const& name)
     {
         // Check the cache for the value
@@ -92,6 +92,10 @@ namespace puppet { namespace logging {
         if (!would_log(level)) {
             return;
         }
+
+        // Serialize messages as the logger may be shared by nodes compiling on different threads
+        // The counts are atomic so that they can be read while other threads are logging
+        lock_guard<mutex> lock{ _mutex };
         if (level == logging::level::warning) {
             ++_warnings;
         } else if (level >= logging::level::error) {
@@ -122,7 +126,9 @@ namespace puppet { namespace logging {
 
     void logger::reset()
     {
-        _warnings = _errors = 0;
+        lock_guard<mutex> lock{ _mutex };
+        _warnings = 0;
+        _errors = 0;
     }
 
     bool logger::would_log(logging::level level)
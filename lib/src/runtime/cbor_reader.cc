@@ -0,0 +1,204 @@
+#include <puppet/runtime/cbor_reader.hpp>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+namespace puppet { namespace runtime {
+
+    // Nesting deeper than this is treated as invalid to bound the recursion
+    static const size_t max_depth = 1024;
+
+    struct cbor_parser
+    {
+        cbor_parser(char const* data, size_t size, data_writer& writer) :
+            _data(reinterpret_cast<uint8_t const*>(data)),
+            _end(reinterpret_cast<uint8_t const*>(data) + size),
+            _writer(writer)
+        {
+        }
+
+        bool parse()
+        {
+            return item(0) && _data == _end;
+        }
+
+     private:
+        bool read(uint8_t& byte)
+        {
+            if (_data == _end) {
+                return false;
+            }
+            byte = *_data++;
+            return true;
+        }
+
+        bool read_argument(uint8_t additional, uint64_t& value)
+        {
+            if (additional < 24) {
+                value = additional;
+                return true;
+            }
+            if (additional > 27) {
+                return false;
+            }
+            size_t bytes = static_cast<size_t>(1) << (additional - 24);
+            if (static_cast<size_t>(_end - _data) < bytes) {
+                return false;
+            }
+            value = 0;
+            for (size_t i = 0; i < bytes; ++i) {
+                value = (value << 8) | *_data++;
+            }
+            return true;
+        }
+
+        bool at_break()
+        {
+            if (_data != _end && *_data == 0xff) {
+                ++_data;
+                return true;
+            }
+            return false;
+        }
+
+        bool item(size_t depth)
+        {
+            uint8_t initial;
+            if (depth > max_depth || !read(initial)) {
+                return false;
+            }
+
+            uint8_t major = initial >> 5;
+            uint8_t additional = initial & 0x1f;
+            bool indefinite = additional == 31 && (major == 4 || major == 5);
+            uint64_t argument = 0;
+            if (!indefinite && major != 7 && !read_argument(additional, argument)) {
+                return false;
+            }
+
+            switch (major) {
+                case 0:
+                    if (argument > static_cast<uint64_t>(numeric_limits<int64_t>::max())) {
+                        return false;
+                    }
+                    _writer.number(static_cast<int64_t>(argument));
+                    return true;
+
+                case 1:
+                    if (argument > static_cast<uint64_t>(numeric_limits<int64_t>::max())) {
+                        return false;
+                    }
+                    _writer.number(-1 - static_cast<int64_t>(argument));
+                    return true;
+
+                case 3:
+                    if (static_cast<uint64_t>(_end - _data) < argument) {
+                        return false;
+                    }
+                    _writer.string(reinterpret_cast<char const*>(_data), static_cast<size_t>(argument));
+                    _data += argument;
+                    return true;
+
+                case 4:
+                    _writer.start_array();
+                    for (uint64_t i = 0; indefinite || i < argument; ++i) {
+                        if (indefinite && at_break()) {
+                            break;
+                        }
+                        if (!item(depth + 1)) {
+                            return false;
+                        }
+                    }
+                    _writer.end_array();
+                    return true;
+
+                case 5:
+                    _writer.start_object();
+                    for (uint64_t i = 0; indefinite || i < argument; ++i) {
+                        if (indefinite && at_break()) {
+                            break;
+                        }
+                        if (!key() || !item(depth + 1)) {
+                            return false;
+                        }
+                    }
+                    _writer.end_object();
+                    return true;
+
+                case 7:
+                    return simple(additional);
+
+                default:
+                    // Byte strings and tags are not supported
+                    return false;
+            }
+        }
+
+        bool key()
+        {
+            uint8_t initial;
+            uint64_t size;
+            if (!read(initial) || (initial >> 5) != 3 || !read_argument(initial & 0x1f, size) || static_cast<uint64_t>(_end - _data) < size) {
+                return false;
+            }
+            _writer.key(reinterpret_cast<char const*>(_data), static_cast<size_t>(size));
+            _data += size;
+            return true;
+        }
+
+        bool simple(uint8_t additional)
+        {
+            switch (additional) {
+                case 20:
+                    _writer.boolean(false);
+                    return true;
+
+                case 21:
+                    _writer.boolean(true);
+                    return true;
+
+                case 22:
+                    _writer.null();
+                    return true;
+
+                case 26: {
+                    uint64_t bits;
+                    if (!read_argument(additional, bits)) {
+                        return false;
+                    }
+                    float value;
+                    auto single = static_cast<uint32_t>(bits);
+                    memcpy(&value, &single, sizeof(value));
+                    _writer.number(static_cast<double>(value));
+                    return true;
+                }
+
+                case 27: {
+                    uint64_t bits;
+                    if (!read_argument(additional, bits)) {
+                        return false;
+                    }
+                    double value;
+                    memcpy(&value, &bits, sizeof(value));
+                    _writer.number(value);
+                    return true;
+                }
+
+                default:
+                    return false;
+            }
+        }
+
+        uint8_t const* _data;
+        uint8_t const* _end;
+        data_writer& _writer;
+    };
+
+    bool read_cbor(char const* data, size_t size, data_writer& writer)
+    {
+        return cbor_parser{ data, size, writer }.parse();
+    }
+
+}}  // namespace puppet::runtime
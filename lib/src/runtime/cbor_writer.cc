@@ -0,0 +1,150 @@
+#include <puppet/runtime/cbor_writer.hpp>
+#include <cstring>
+
+using namespace std;
+
+namespace puppet { namespace runtime {
+
+    // CBOR major types
+    static const uint8_t unsigned_integer = 0;
+    static const uint8_t negative_integer = 1;
+    static const uint8_t text_string = 3;
+    static const uint8_t array = 4;
+    static const uint8_t map = 5;
+
+    // CBOR simple values and special bytes
+    static const uint8_t false_value = 0xf4;
+    static const uint8_t true_value = 0xf5;
+    static const uint8_t null_value = 0xf6;
+    static const uint8_t double_value = 0xfb;
+    static const uint8_t indefinite_array = 0x9f;
+    static const uint8_t indefinite_map = 0xbf;
+    static const uint8_t break_value = 0xff;
+
+    cbor_writer::cbor_writer(ostream& out) :
+        _out(out),
+        _size(0)
+    {
+    }
+
+    cbor_writer::~cbor_writer()
+    {
+        flush();
+    }
+
+    void cbor_writer::null()
+    {
+        put(null_value);
+    }
+
+    void cbor_writer::boolean(bool value)
+    {
+        put(value ? true_value : false_value);
+    }
+
+    void cbor_writer::number(int64_t value)
+    {
+        if (value >= 0) {
+            write_head(unsigned_integer, static_cast<uint64_t>(value));
+        } else {
+            // Negative integers are encoded as -1 - n
+            write_head(negative_integer, static_cast<uint64_t>(-1 - value));
+        }
+    }
+
+    void cbor_writer::number(double value)
+    {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        put(double_value);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            put(static_cast<uint8_t>(bits >> shift));
+        }
+    }
+
+    void cbor_writer::string(char const* value, size_t size)
+    {
+        write_head(text_string, size);
+        write(value, size);
+    }
+
+    void cbor_writer::key(char const* name, size_t size)
+    {
+        string(name, size);
+    }
+
+    void cbor_writer::start_object()
+    {
+        put(indefinite_map);
+    }
+
+    void cbor_writer::end_object()
+    {
+        put(break_value);
+    }
+
+    void cbor_writer::start_array()
+    {
+        put(indefinite_array);
+    }
+
+    void cbor_writer::end_array()
+    {
+        put(break_value);
+    }
+
+    void cbor_writer::flush()
+    {
+        _out.write(_buffer, _size);
+        _size = 0;
+    }
+
+    void cbor_writer::write_head(uint8_t major, uint64_t value)
+    {
+        major <<= 5;
+        if (value < 24) {
+            put(major | static_cast<uint8_t>(value));
+            return;
+        }
+
+        // Use the smallest of the 1, 2, 4, or 8 byte big-endian encodings
+        int bytes = 8;
+        uint8_t additional = 27;
+        if (value <= 0xff) {
+            bytes = 1;
+            additional = 24;
+        } else if (value <= 0xffff) {
+            bytes = 2;
+            additional = 25;
+        } else if (value <= 0xffffffff) {
+            bytes = 4;
+            additional = 26;
+        }
+        put(major | additional);
+        for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+            put(static_cast<uint8_t>(value >> shift));
+        }
+    }
+
+    void cbor_writer::write(char const* data, size_t size)
+    {
+        if (size > sizeof(_buffer) - _size) {
+            flush();
+            if (size > sizeof(_buffer)) {
+                _out.write(data, size);
+                return;
+            }
+        }
+        memcpy(_buffer + _size, data, size);
+        _size += size;
+    }
+
+    void cbor_writer::put(uint8_t byte)
+    {
+        if (_size == sizeof(_buffer)) {
+            flush();
+        }
+        _buffer[_size++] = static_cast<char>(byte);
+    }
+
+}}  // namespace puppet::runtime
@@ -0,0 +1,204 @@
+#include <puppet/runtime/digest.hpp>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+namespace puppet { namespace runtime {
+
+    // The kinds of items hashed by the digest writer
+    enum item_kind : uint8_t
+    {
+        null_item = 1,
+        boolean_item,
+        integer_item,
+        float_item,
+        string_item,
+        key_item,
+        start_object_item,
+        end_object_item,
+        start_array_item,
+        end_array_item
+    };
+
+    // 128-bit FNV-1a; the prime is 2^88 + 2^8 + 0x3b, so the multiply is a shift and a small multiply
+    __extension__ typedef unsigned __int128 uint128;
+
+    static const uint128 fnv_offset = (static_cast<uint128>(0x6c62272e07bb0142ull) << 64) | 0x62b821756295c58dull;
+
+    static inline uint128 fnv_multiply(uint128 value)
+    {
+        return (value << 88) + value * 0x13bu;
+    }
+
+    digest::digest() :
+        _high(0),
+        _low(0)
+    {
+    }
+
+    digest::digest(uint64_t high, uint64_t low) :
+        _high(high),
+        _low(low)
+    {
+    }
+
+    uint64_t digest::high() const
+    {
+        return _high;
+    }
+
+    uint64_t digest::low() const
+    {
+        return _low;
+    }
+
+    string digest::to_string() const
+    {
+        ostringstream ss;
+        ss << *this;
+        return ss.str();
+    }
+
+    digest& digest::operator+=(digest const& other)
+    {
+        auto value = ((static_cast<uint128>(_high) << 64) | _low) + ((static_cast<uint128>(other._high) << 64) | other._low);
+        _high = static_cast<uint64_t>(value >> 64);
+        _low = static_cast<uint64_t>(value);
+        return *this;
+    }
+
+    digest& digest::operator-=(digest const& other)
+    {
+        auto value = ((static_cast<uint128>(_high) << 64) | _low) - ((static_cast<uint128>(other._high) << 64) | other._low);
+        _high = static_cast<uint64_t>(value >> 64);
+        _low = static_cast<uint64_t>(value);
+        return *this;
+    }
+
+    bool operator==(digest const& left, digest const& right)
+    {
+        return left.high() == right.high() && left.low() == right.low();
+    }
+
+    bool operator!=(digest const& left, digest const& right)
+    {
+        return !(left == right);
+    }
+
+    ostream& operator<<(ostream& os, digest const& value)
+    {
+        auto flags = os.flags();
+        auto fill = os.fill('0');
+        os << hex << setw(16) << value.high() << setw(16) << value.low();
+        os.fill(fill);
+        os.flags(flags);
+        return os;
+    }
+
+    digest_writer::digest_writer() :
+        _high(static_cast<uint64_t>(fnv_offset >> 64)),
+        _low(static_cast<uint64_t>(fnv_offset))
+    {
+    }
+
+    digest digest_writer::result() const
+    {
+        return { _high, _low };
+    }
+
+    void digest_writer::null()
+    {
+        update(null_item);
+    }
+
+    void digest_writer::boolean(bool value)
+    {
+        uint8_t byte = value ? 1 : 0;
+        update(boolean_item, &byte, sizeof(byte));
+    }
+
+    void digest_writer::number(int64_t value)
+    {
+        // Hash in little endian order so that the digest does not depend on the platform
+        uint8_t bytes[sizeof(value)];
+        auto bits = static_cast<uint64_t>(value);
+        for (size_t i = 0; i < sizeof(bytes); ++i) {
+            bytes[i] = static_cast<uint8_t>(bits >> (i * 8));
+        }
+        update(integer_item, bytes, sizeof(bytes));
+    }
+
+    void digest_writer::number(double value)
+    {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        uint8_t bytes[sizeof(bits)];
+        for (size_t i = 0; i < sizeof(bytes); ++i) {
+            bytes[i] = static_cast<uint8_t>(bits >> (i * 8));
+        }
+        update(float_item, bytes, sizeof(bytes));
+    }
+
+    void digest_writer::string(char const* value, size_t size)
+    {
+        update(string_item, value, size);
+    }
+
+    void digest_writer::key(char const* name, size_t size)
+    {
+        update(key_item, name, size);
+    }
+
+    void digest_writer::start_object()
+    {
+        update(start_object_item);
+    }
+
+    void digest_writer::end_object()
+    {
+        update(end_object_item);
+    }
+
+    void digest_writer::start_array()
+    {
+        update(start_array_item);
+    }
+
+    void digest_writer::end_array()
+    {
+        update(end_array_item);
+    }
+
+    void digest_writer::flush()
+    {
+    }
+
+    void digest_writer::update(uint8_t kind, void const* data, size_t size)
+    {
+        auto hash = (static_cast<uint128>(_high) << 64) | _low;
+
+        hash ^= kind;
+        hash = fnv_multiply(hash);
+
+        // Hash the size of variable length data so that adjacent items cannot be confused
+        if (kind == string_item || kind == key_item) {
+            auto length = static_cast<uint64_t>(size);
+            for (size_t i = 0; i < sizeof(length); ++i) {
+                hash ^= static_cast<uint8_t>(length >> (i * 8));
+                hash = fnv_multiply(hash);
+            }
+        }
+
+        auto bytes = static_cast<uint8_t const*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash = fnv_multiply(hash);
+        }
+
+        _high = static_cast<uint64_t>(hash >> 64);
+        _low = static_cast<uint64_t>(hash);
+    }
+
+}}  // namespace puppet::runtime
@@ -0,0 +1,114 @@
+#include <puppet/runtime/json_reader.hpp>
+#include <rapidjson/reader.h>
+#include <rapidjson/memorystream.h>
+#include <limits>
+
+using namespace std;
+using namespace rapidjson;
+
+namespace puppet { namespace runtime {
+
+    struct json_handler
+    {
+        explicit json_handler(data_writer& writer) :
+            _writer(writer)
+        {
+        }
+
+        bool Null()
+        {
+            _writer.null();
+            return true;
+        }
+
+        bool Bool(bool value)
+        {
+            _writer.boolean(value);
+            return true;
+        }
+
+        bool Int(int value)
+        {
+            _writer.number(static_cast<int64_t>(value));
+            return true;
+        }
+
+        bool Uint(unsigned int value)
+        {
+            _writer.number(static_cast<int64_t>(value));
+            return true;
+        }
+
+        bool Int64(int64_t value)
+        {
+            _writer.number(value);
+            return true;
+        }
+
+        bool Uint64(uint64_t value)
+        {
+            // Values that do not fit in a signed integer cannot be represented exactly
+            if (value > static_cast<uint64_t>(numeric_limits<int64_t>::max())) {
+                _writer.number(static_cast<double>(value));
+            } else {
+                _writer.number(static_cast<int64_t>(value));
+            }
+            return true;
+        }
+
+        bool Double(double value)
+        {
+            _writer.number(value);
+            return true;
+        }
+
+        bool String(char const* value, SizeType size, bool)
+        {
+            _writer.string(value, size);
+            return true;
+        }
+
+        bool StartObject()
+        {
+            _writer.start_object();
+            return true;
+        }
+
+        bool Key(char const* name, SizeType size, bool)
+        {
+            _writer.key(name, size);
+            return true;
+        }
+
+        bool EndObject(SizeType)
+        {
+            _writer.end_object();
+            return true;
+        }
+
+        bool StartArray()
+        {
+            _writer.start_array();
+            return true;
+        }
+
+        bool EndArray(SizeType)
+        {
+            _writer.end_array();
+            return true;
+        }
+
+     private:
+        data_writer& _writer;
+    };
+
+    bool read_json(char const* data, size_t size, data_writer& writer)
+    {
+        // Parse with full precision so that floating point values read back exactly as they were written
+        MemoryStream stream{data, size};
+        json_handler handler{writer};
+        Reader reader;
+        return !reader.Parse<kParseFullPrecisionFlag | kParseValidateEncodingFlag>(stream, handler).IsError();
+    }
+
+}}  // namespace puppet::runtime
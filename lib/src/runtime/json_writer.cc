@@ -0,0 +1,132 @@
+#include <puppet/runtime/json_writer.hpp>
+#include <rapidjson/writer.h>
+#include <rapidjson/prettywriter.h>
+
+using namespace std;
+
+namespace puppet { namespace runtime {
+
+    // Output stream for RapidJSON that buffers writes to the underlying stream
+    struct buffered_stream
+    {
+        typedef char Ch;
+
+        explicit buffered_stream(ostream& out) :
+            _out(out),
+            _size(0)
+        {
+        }
+
+        void Put(char c)
+        {
+            if (_size == sizeof(_buffer)) {
+                Flush();
+            }
+            _buffer[_size++] = c;
+        }
+
+        void Flush()
+        {
+            _out.write(_buffer, _size);
+            _size = 0;
+        }
+
+     private:
+        ostream& _out;
+        size_t _size;
+        char _buffer[64 * 1024];
+    };
+
+    struct json_writer::state
+    {
+        state(ostream& out, bool pretty) :
+            stream(out),
+            pretty(pretty),
+            pretty_writer(stream),
+            compact_writer(stream)
+        {
+            pretty_writer.SetIndent(' ', 2);
+        }
+
+        template <typename Callback>
+        void write(Callback const& callback)
+        {
+            if (pretty) {
+                callback(pretty_writer);
+            } else {
+                callback(compact_writer);
+            }
+        }
+
+        buffered_stream stream;
+        bool pretty;
+        rapidjson::PrettyWriter<buffered_stream> pretty_writer;
+        rapidjson::Writer<buffered_stream> compact_writer;
+    };
+
+    json_writer::json_writer(ostream& out, bool pretty) :
+        _state(new state(out, pretty))
+    {
+    }
+
+    json_writer::~json_writer()
+    {
+        flush();
+    }
+
+    void json_writer::null()
+    {
+        _state->write([](auto& writer) { writer.Null(); });
+    }
+
+    void json_writer::boolean(bool value)
+    {
+        _state->write([&](auto& writer) { writer.Bool(value); });
+    }
+
+    void json_writer::number(int64_t value)
+    {
+        _state->write([&](auto& writer) { writer.Int64(value); });
+    }
+
+    void json_writer::number(double value)
+    {
+        _state->write([&](auto& writer) { writer.Double(value); });
+    }
+
+    void json_writer::string(char const* value, size_t size)
+    {
+        _state->write([&](auto& writer) { writer.String(value, static_cast<rapidjson::SizeType>(size)); });
+    }
+
+    void json_writer::key(char const* name, size_t size)
+    {
+        _state->write([&](auto& writer) { writer.Key(name, static_cast<rapidjson::SizeType>(size)); });
+    }
+
+    void json_writer::start_object()
+    {
+        _state->write([](auto& writer) { writer.StartObject(); });
+    }
+
+    void json_writer::end_object()
+    {
+        _state->write([](auto& writer) { writer.EndObject(); });
+    }
+
+    void json_writer::start_array()
+    {
+        _state->write([](auto& writer) { writer.StartArray(); });
+    }
+
+    void json_writer::end_array()
+    {
+        _state->write([](auto& writer) { writer.EndArray(); });
+    }
+
+    void json_writer::flush()
+    {
+        _state->stream.Flush();
+    }
+
+}}  // namespace puppet::runtime
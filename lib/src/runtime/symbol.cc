@@ -0,0 +1,169 @@
+#include <puppet/runtime/symbol.hpp>
+#include <puppet/cast.hpp>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+using namespace std;
+
+namespace puppet { namespace runtime {
+
+    struct symbol::entry
+    {
+        entry(size_t hash, string value) :
+            hash(hash),
+            value(rvalue_cast(value)),
+            references(1)
+        {
+        }
+
+        size_t const hash;
+        string const value;
+        atomic<size_t> references;
+    };
+
+    struct symbol::table
+    {
+        static table& instance()
+        {
+            static table instance;
+            return instance;
+        }
+
+        // The table is keyed by each string's hash so that the hash is only computed once per lookup
+        // The nodes of an unordered map are never moved, so entries are stable
+        shared_timed_mutex mutex;
+        unordered_multimap<size_t, entry> entries;
+    };
+
+    symbol::symbol()
+    {
+        static symbol const empty{ string{} };
+        _entry = empty._entry;
+        ++_entry->references;
+    }
+
+    symbol::symbol(string const& value) :
+        _entry(intern(value))
+    {
+    }
+
+    symbol::symbol(symbol const& other) :
+        _entry(other._entry)
+    {
+        ++_entry->references;
+    }
+
+    symbol& symbol::operator=(symbol const& other)
+    {
+        if (_entry != other._entry) {
+            ++other._entry->references;
+            release(_entry);
+            _entry = other._entry;
+        }
+        return *this;
+    }
+
+    symbol::~symbol()
+    {
+        release(_entry);
+    }
+
+    string const& symbol::str() const
+    {
+        return _entry->value;
+    }
+
+    size_t symbol::hash() const
+    {
+        return _entry->hash;
+    }
+
+    bool symbol::empty() const
+    {
+        return _entry->value.empty();
+    }
+
+    bool symbol::operator==(symbol const& other) const
+    {
+        return _entry == other._entry;
+    }
+
+    bool symbol::operator!=(symbol const& other) const
+    {
+        return _entry != other._entry;
+    }
+
+    symbol::entry* symbol::intern(string const& value)
+    {
+        auto& mutex = table::instance().mutex;
+        auto& entries = table::instance().entries;
+
+        auto hash = std::hash<string>()(value);
+        auto find = [&]() -> entry* {
+            auto range = entries.equal_range(hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (it->second.value == value) {
+                    // Take the reference while locked so that a concurrent release cannot remove the entry
+                    ++it->second.references;
+                    return &it->second;
+                }
+            }
+            return nullptr;
+        };
+
+        // Most strings are already interned, so look them up under a shared lock first
+        {
+            shared_lock<shared_timed_mutex> lock{ mutex };
+            if (auto existing = find()) {
+                return existing;
+            }
+        }
+
+        // Look again as another thread may have interned the string before the lock was taken
+        unique_lock<shared_timed_mutex> lock{ mutex };
+        if (auto existing = find()) {
+            return existing;
+        }
+        return &entries.emplace(piecewise_construct, forward_as_tuple(hash), forward_as_tuple(hash, value))->second;
+    }
+
+    void symbol::release(entry* value)
+    {
+        // Releasing a reference that is not the last one does not need the lock
+        auto count = value->references.load();
+        while (count > 1) {
+            if (value->references.compare_exchange_weak(count, count - 1)) {
+                return;
+            }
+        }
+
+        // Possibly the last reference: remove the entry under the lock so that it cannot be found while being removed
+        auto& instance = table::instance();
+        unique_lock<shared_timed_mutex> lock{ instance.mutex };
+        if (--value->references > 0) {
+            return;
+        }
+        auto& entries = instance.entries;
+        auto range = entries.equal_range(value->hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (&it->second == value) {
+                entries.erase(it);
+                return;
+            }
+        }
+    }
+
+    ostream& operator<<(ostream& os, symbol const& value)
+    {
+        os << value.str();
+        return os;
+    }
+
+    size_t hash_value(symbol const& value)
+    {
+        return value.hash();
+    }
+
+}}  // namespace puppet::runtime
@@ -67,7 +67,7 @@ namespace puppet { namespace runtime { namespace types {
 
         // Check that each element is of the type
         for (auto const& element : *ptr) {
-            if (!_element_type->is_instance(*element)) {
+            if (!_element_type->is_instance(element)) {
                 return false;
             }
         }
@@ -9,27 +9,32 @@ using namespace std;
 
 namespace puppet { namespace runtime { namespace types {
 
-    resource::resource(std::string type_name, std::string title) :
-        _type_name(rvalue_cast(type_name)),
-        _title(rvalue_cast(title))
+    static symbol normalize_type_name(std::string type_name)
     {
         // Make the type name lowercase
-        boost::to_lower(_type_name);
+        boost::to_lower(type_name);
 
         // Now uppercase every start of a type name
         boost::split_iterator<std::string::iterator> end;
-        for (auto it = boost::make_split_iterator(_type_name, boost::first_finder("::", boost::is_equal())); it != end; ++it) {
+        for (auto it = boost::make_split_iterator(type_name, boost::first_finder("::", boost::is_equal())); it != end; ++it) {
             if (!*it) {
                 continue;
             }
             auto range = boost::make_iterator_range(it->begin(), it->begin() + 1);
             boost::to_upper(range);
         }
+        return symbol{ type_name };
+    }
+
+    resource::resource(std::string type_name, std::string title) :
+        _type_name(normalize_type_name(rvalue_cast(type_name))),
+        _title(rvalue_cast(title))
+    {
     }
 
     std::string const& resource::type_name() const
     {
-        return _type_name;
+        return _type_name.str();
     }
 
     std::string const& resource::title() const
@@ -44,12 +49,14 @@ namespace puppet { namespace runtime { namespace types {
 
     bool resource::is_class() const
     {
-        return _type_name == "Class";
+        static const symbol class_name{ "Class" };
+        return _type_name == class_name;
     }
 
     bool resource::is_stage() const
     {
-        return _type_name == "Stage";
+        static const symbol stage_name{ "Stage" };
+        return _type_name == stage_name;
     }
 
     bool resource::is_builtin() const
@@ -107,7 +114,7 @@ namespace puppet { namespace runtime { namespace types {
             "Zone",
             "Zpool"
         };
-        return builtin_types.count(_type_name) > 0;
+        return builtin_types.count(_type_name.str()) > 0;
     }
 
     char const* resource::name()
@@ -132,10 +139,10 @@ namespace puppet { namespace runtime { namespace types {
             return true;
         }
         // Check type name
-        if (_type_name != resource_ptr->type_name()) {
+        if (_type_name != resource_ptr->_type_name) {
             return false;
         }
-        return _title.empty() || _title == resource_ptr->title();
+        return _title.empty() || _title == resource_ptr->_title;
     }
 
     bool resource::is_specialization(values::type const& other) const
@@ -151,7 +158,7 @@ namespace puppet { namespace runtime { namespace types {
             return !resource->type_name().empty();
         }
         // Otherwise, the types need to be the same
-        if (_type_name != resource->type_name()) {
+        if (_type_name != resource->_type_name) {
             return false;
         }
         // Otherwise, the other one is a specialization if this does not have a title but the other one does
@@ -195,7 +202,7 @@ namespace puppet { namespace runtime { namespace types {
 
     bool operator==(resource const& left, resource const& right)
     {
-        return left.type_name() == right.type_name() && left.title() == right.title();
+        return left._type_name == right._type_name && left._title == right._title;
     }
 
     bool operator!=(resource const& left, resource const& right)
@@ -209,8 +216,8 @@ namespace puppet { namespace runtime { namespace types {
 
         size_t seed = 0;
         boost::hash_combine(seed, name_hash);
-        boost::hash_combine(seed, type.type_name());
-        boost::hash_combine(seed, type.title());
+        boost::hash_combine(seed, type._type_name.hash());
+        boost::hash_combine(seed, type._title);
         return seed;
     }
 
@@ -88,10 +88,10 @@ namespace puppet { namespace runtime { namespace types {
             // If this element's position is in the tuple, match the type
             // If not, match the last type
             if (i < _types.size()) {
-                if (!_types[i]->is_instance(*element)) {
+                if (!_types[i]->is_instance(element)) {
                     return false;
                 }
-            } else if (!last_type->is_instance(*element)) {
+            } else if (!last_type->is_instance(element)) {
                 return false;
             }
         }
@@ -5,7 +5,93 @@ using namespace std;
 
 namespace puppet { namespace runtime { namespace values {
 
-    void array::join(ostream& os, string const& separator)
+    array::sequence_type const array::_empty;
+
+    array::array(size_type count) :
+        _elements(std::make_shared<sequence_type>(count))
+    {
+    }
+
+    array::array(initializer_list<value_type> elements) :
+        _elements(std::make_shared<sequence_type>(elements))
+    {
+    }
+
+    void array::reserve(size_type capacity)
+    {
+        mutate().reserve(capacity);
+    }
+
+    void array::resize(size_type count)
+    {
+        mutate().resize(count);
+    }
+
+    void array::clear()
+    {
+        // Release shared elements rather than copying them only to clear the copy
+        if (_elements.use_count() == 1) {
+            _elements->clear();
+        } else {
+            _elements.reset();
+        }
+    }
+
+    void array::push_back(value_type const& element)
+    {
+        mutate().push_back(element);
+    }
+
+    void array::push_back(value_type&& element)
+    {
+        mutate().push_back(rvalue_cast(element));
+    }
+
+    void array::pop_back()
+    {
+        mutate().pop_back();
+    }
+
+    array::iterator array::insert(const_iterator position, value_type element)
+    {
+        // Rebase the position as the elements may be copied if they are shared
+        auto offset = position - elements().begin();
+        auto& sequence = mutate();
+        return sequence.insert(sequence.begin() + offset, rvalue_cast(element));
+    }
+
+    array::iterator array::erase(const_iterator position)
+    {
+        auto offset = position - elements().begin();
+        auto& sequence = mutate();
+        return sequence.erase(sequence.begin() + offset);
+    }
+
+    array::iterator array::erase(const_iterator first, const_iterator last)
+    {
+        auto offset = first - elements().begin();
+        auto count = last - first;
+        auto& sequence = mutate();
+        return sequence.erase(sequence.begin() + offset, sequence.begin() + offset + count);
+    }
+
+    void array::swap(array& other) noexcept
+    {
+        _elements.swap(other._elements);
+    }
+
+    array::sequence_type& array::mutate()
+    {
+        // Copy the elements if they are shared with another array
+        if (!_elements) {
+            _elements = std::make_shared<sequence_type>();
+        } else if (_elements.use_count() > 1) {
+            _elements = std::make_shared<sequence_type>(*_elements);
+        }
+        return *_elements;
+    }
+
+    void array::join(ostream& os, string const& separator) const
     {
         bool first = true;
         for (auto const& element : *this) {
@@ -14,7 +100,7 @@ namespace puppet { namespace runtime { namespace values {
             } else {
                 os << separator;
             }
-            os << *element;
+            os << element;
         }
     }
 
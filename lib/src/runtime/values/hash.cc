@@ -4,129 +4,195 @@ using namespace std;
 
 namespace puppet { namespace runtime { namespace values {
 
-    hash::pair::pair(values::value key, values::value value) :
-        _key(rvalue_cast(key)),
-        _value(rvalue_cast(value))
+    static size_t hash_key(string const& key)
     {
+        return boost::hash_value(key);
     }
 
-    values::value const& hash::pair::key() const
+    static size_t hash_key(value const& key)
     {
-        return _key;
+        // String keys are the common case, so hash them without visiting the value
+        if (auto str = key.as<string>()) {
+            return hash_key(*str);
+        }
+        return hash_value(key);
     }
 
-    values::value& hash::pair::value()
+    static bool key_equals(value const& key, string const& other)
     {
-        return _value;
+        auto str = key.as<string>();
+        return str && *str == other;
     }
 
-    values::value const& hash::pair::value() const
+    static bool key_equals(value const& key, value const& other)
     {
-        return _value;
+        if (auto str = other.as<string>()) {
+            return key_equals(key, *str);
+        }
+        return key == other;
     }
 
-    hash::hash(hash const& other)
-    {
-        operator=(other);
-    }
+    // Marks an unused slot in the index
+    static uint32_t const empty_slot = numeric_limits<uint32_t>::max();
 
-    hash& hash::operator=(hash const& other)
+    struct hash::storage
     {
-        // Copy the elements
-        _elements = other._elements;
+        template <typename Key>
+        size_t find(size_t hash, Key const& key) const
+        {
+            // Linear probe from the key's home slot until the key or an empty slot is found
+            // The index is kept at most two-thirds full, so an empty slot is always found
+            size_t mask = index.size() - 1;
+            for (size_t slot = home(hash) & mask;; slot = (slot + 1) & mask) {
+                auto position = index[slot];
+                if (position == empty_slot || (hashes[position] == hash && key_equals(elements[position].key(), key))) {
+                    return slot;
+                }
+            }
+        }
+
+        template <typename Key>
+        pair const* get(Key const& key) const
+        {
+            if (index.empty()) {
+                return nullptr;
+            }
+            auto position = index[find(hash_key(key), key)];
+            return position == empty_slot ? nullptr : &elements[position];
+        }
 
-        // Rebuild the index as it is reference-based
-        _index.clear();
-        _index.reserve(_elements.size());
-        for (auto it = _elements.begin(); it != _elements.end(); ++it) {
-            _index.emplace(&it->key(), it);
+        void reserve(size_t count)
+        {
+            if (count * 3 <= index.size() * 2) {
+                return;
+            }
+            size_t capacity = index.empty() ? 8 : index.size();
+            while (count * 3 > capacity * 2) {
+                capacity *= 2;
+            }
+            reindex(capacity);
         }
-        return *this;
-    }
+
+        void reindex(size_t capacity)
+        {
+            index.assign(capacity, empty_slot);
+            size_t mask = capacity - 1;
+            for (size_t position = 0; position < elements.size(); ++position) {
+                size_t slot = home(hashes[position]) & mask;
+                while (index[slot] != empty_slot) {
+                    slot = (slot + 1) & mask;
+                }
+                index[slot] = static_cast<uint32_t>(position);
+            }
+        }
+
+        // The pairs in insertion order
+        sequence_type elements;
+        // The cached hash of each pair's key, parallel to the pairs
+        vector<size_t> hashes;
+        // The index of pair positions; the size is zero or a power of two
+        vector<uint32_t> index;
+
+     private:
+        static size_t home(size_t hash)
+        {
+            // Mix the hash so that keys with similar hashes (e.g. integers) do not cluster
+            return static_cast<size_t>((static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> 32);
+        }
+    };
+
+    hash::storage const hash::_empty;
 
     hash::iterator hash::begin()
     {
-        return _elements.begin();
+        return mutate().elements.begin();
     }
 
     hash::const_iterator hash::begin() const
     {
-        return _elements.begin();
+        return elements().elements.begin();
     }
 
     hash::iterator hash::end()
     {
-        return _elements.end();
+        return mutate().elements.end();
     }
 
     hash::const_iterator hash::end() const
     {
-        return _elements.end();
+        return elements().elements.end();
     }
 
     hash::const_iterator hash::cbegin() const
     {
-        return _elements.cbegin();
+        return elements().elements.cbegin();
     }
 
     hash::const_iterator hash::cend() const
     {
-        return _elements.cend();
+        return elements().elements.cend();
     }
 
     hash::reverse_iterator hash::rbegin()
     {
-        return _elements.rbegin();
+        return mutate().elements.rbegin();
     }
 
     hash::const_reverse_iterator hash::rbegin() const
     {
-        return _elements.rbegin();
+        return elements().elements.rbegin();
     }
 
     hash::reverse_iterator hash::rend()
     {
-        return _elements.rend();
+        return mutate().elements.rend();
     }
 
     hash::const_reverse_iterator hash::rend() const
     {
-        return _elements.rend();
+        return elements().elements.rend();
     }
 
     hash::const_reverse_iterator hash::crbegin() const
     {
-        return _elements.crbegin();
+        return elements().elements.crbegin();
     }
 
     hash::const_reverse_iterator hash::crend() const
     {
-        return _elements.crend();
+        return elements().elements.crend();
     }
 
     size_t hash::size() const
     {
-        return _elements.size();
+        return elements().elements.size();
     }
 
     bool hash::empty() const
     {
-        return _elements.empty();
+        return elements().elements.empty();
     }
 
     void hash::set(value key, values::value value)
     {
-        auto it = _index.find(&key);
-        if (it != _index.end()) {
-            it->second->value() = rvalue_cast(value);
+        auto& storage = mutate();
+        storage.reserve(storage.elements.size() + 1);
+
+        auto key_hash = hash_key(key);
+        auto slot = storage.find(key_hash, key);
+        auto position = storage.index[slot];
+        if (position != empty_slot) {
+            storage.elements[position].value() = rvalue_cast(value);
             return;
         }
-        auto element = _elements.emplace(_elements.end(), rvalue_cast(key), rvalue_cast(value));
-        _index[&element->key()] = element;
+        storage.index[slot] = static_cast<uint32_t>(storage.elements.size());
+        storage.elements.emplace_back(rvalue_cast(key), rvalue_cast(value));
+        storage.hashes.push_back(key_hash);
     }
 
     void hash::set(const_iterator begin, const_iterator end)
     {
+        mutate().reserve(size() + static_cast<size_t>(end - begin));
         while (begin != end) {
             set(begin->key(), begin->value());
             ++begin;
@@ -135,37 +201,68 @@ namespace puppet { namespace runtime { namespace values {
 
     value* hash::get(value const& key)
     {
-        return const_cast<value*>(static_cast<hash const*>(this)->get(key));
+        // Avoid copying shared elements if the key is not present
+        auto pair = elements().get(key);
+        if (!pair) {
+            return nullptr;
+        }
+        auto position = pair - elements().elements.data();
+        return &mutate().elements[position].value();
     }
 
     value const* hash::get(value const& key) const
     {
-        auto it = _index.find(&key);
-        if (it == _index.end()) {
+        auto pair = elements().get(key);
+        return pair ? &pair->value() : nullptr;
+    }
+
+    value* hash::get(string const& key)
+    {
+        // Avoid copying shared elements if the key is not present
+        auto pair = elements().get(key);
+        if (!pair) {
             return nullptr;
         }
-        return &it->second->value();
+        auto position = pair - elements().elements.data();
+        return &mutate().elements[position].value();
+    }
+
+    value const* hash::get(string const& key) const
+    {
+        auto pair = elements().get(key);
+        return pair ? &pair->value() : nullptr;
     }
 
     bool hash::erase(value const& key)
     {
-        auto it = _index.find(&key);
-        if (it == _index.end()) {
+        auto pair = elements().get(key);
+        if (!pair) {
             return false;
         }
-        _elements.erase(it->second);
-        _index.erase(it);
+        auto position = pair - elements().elements.data();
+        auto& storage = mutate();
+        storage.elements.erase(storage.elements.begin() + position);
+        storage.hashes.erase(storage.hashes.begin() + position);
+
+        // Erasing shifts the positions of the following pairs, so rebuild the index
+        storage.reindex(storage.index.size());
         return true;
     }
 
-    size_t hash::indirect_hasher::operator()(values::value const* value) const
+    hash::storage const& hash::elements() const
     {
-        return hash_value(*value);
+        return _storage ? *_storage : _empty;
     }
 
-    bool hash::indirect_comparer::operator()(values::value const* right, values::value const* left) const
+    hash::storage& hash::mutate()
     {
-        return *right == *left;
+        // Copy the elements if they are shared with another hash
+        if (!_storage) {
+            _storage = std::make_shared<storage>();
+        } else if (_storage.use_count() > 1) {
+            _storage = std::make_shared<storage>(*_storage);
+        }
+        return *_storage;
     }
 
     ostream& operator<<(ostream& os, values::hash const& hash)
@@ -1,5 +1,8 @@
 #include <puppet/runtime/values/value.hpp>
 #include <puppet/cast.hpp>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 
 using namespace std;
 
@@ -10,19 +13,61 @@ namespace puppet { namespace runtime { namespace values {
     }
 
     regex::regex(string pattern) :
-        _regex(pattern)
+        _compiled(compile(rvalue_cast(pattern)))
     {
-        _pattern = rvalue_cast(pattern);
     }
 
     string const& regex::pattern() const
     {
-        return _pattern;
+        static string const empty;
+        return _compiled ? _compiled->pattern : empty;
     }
 
     std::regex const& regex::value() const
     {
-        return _regex;
+        static std::regex const empty;
+        return _compiled ? _compiled->value : empty;
+    }
+
+    shared_ptr<regex::compiled const> regex::compile(string pattern)
+    {
+        // The maximum number of compiled regexes to keep; the least recently used is evicted first
+        static size_t const capacity = 1024;
+
+        // The cache keeps the most recently used regex at the front of the list
+        using list_type = list<shared_ptr<compiled const>>;
+        static mutex lock;
+        static list_type recent;
+        static unordered_map<string, list_type::iterator> index;
+
+        {
+            lock_guard<mutex> guard{ lock };
+            auto it = index.find(pattern);
+            if (it != index.end()) {
+                recent.splice(recent.begin(), recent, it->second);
+                return *it->second;
+            }
+        }
+
+        // Compile outside of the lock as compilation is expensive; errors are not cached
+        std::regex value(pattern);
+        auto result = std::make_shared<compiled const>(compiled{ pattern, rvalue_cast(value) });
+
+        lock_guard<mutex> guard{ lock };
+
+        // Another thread may have compiled the same pattern in the meantime
+        auto it = index.find(pattern);
+        if (it != index.end()) {
+            recent.splice(recent.begin(), recent, it->second);
+            return *it->second;
+        }
+        recent.push_front(result);
+        index.emplace(rvalue_cast(pattern), recent.begin());
+        if (recent.size() > capacity) {
+            index.erase(recent.back()->pattern);
+            recent.pop_back();
+        }
+        return result;
     }
 
     ostream& operator<<(ostream& os, regex const& regx)
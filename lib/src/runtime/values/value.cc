@@ -1,14 +1,13 @@
 #include <puppet/runtime/values/value.hpp>
+#include <puppet/runtime/data_writer.hpp>
 #include <puppet/compiler/evaluation/collectors/collector.hpp>
 #include <puppet/cast.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
-#include <rapidjson/document.h>
 #include <utf8.h>
 
 using namespace std;
-using namespace rapidjson;
 using namespace puppet::runtime;
 using namespace puppet::compiler::evaluation;
 
@@ -249,7 +248,7 @@ namespace puppet { namespace runtime { namespace values {
         } else if (auto array = as<values::array>()) {
             // For arrays, recurse on each element
             for (auto& element : *array) {
-                element->each_resource(callback, error);
+                element.each_resource(callback, error);
             }
             return;
         }
@@ -263,108 +262,85 @@ namespace puppet { namespace runtime { namespace values {
         }
     }
 
-    struct json_visitor : boost::static_visitor<json_value>
+    struct write_visitor : boost::static_visitor<>
     {
-        json_visitor(json_allocator& allocator) :
-            _allocator(allocator)
+        explicit write_visitor(data_writer& writer) :
+            _writer(writer)
         {
         }
 
         result_type operator()(undef const&) const
         {
-            json_value value;
-            value.SetNull();
-            return value;
+            _writer.null();
         }
 
         result_type operator()(defaulted const&) const
         {
-            json_value value;
-            value.SetString("default");
-            return value;
+            _writer.string("default");
         }
 
         result_type operator()(int64_t i) const
         {
-            json_value value;
-            value.SetInt64(i);
-            return value;
+            _writer.number(i);
         }
 
         result_type operator()(long double d) const
         {
-            json_value value;
-            value.SetDouble(static_cast<double>(d));
-            return value;
+            _writer.number(static_cast<double>(d));
         }
 
         result_type operator()(bool b) const
         {
-            json_value value;
-            value.SetBool(b);
-            return value;
+            _writer.boolean(b);
         }
 
         result_type operator()(string const& s) const
         {
-            json_value value;
-            value.SetString(StringRef(s.c_str(), s.size()));
-            return value;
+            _writer.string(s);
         }
 
         result_type operator()(values::regex const& regex) const
         {
-            auto const& pattern = regex.pattern();
-            json_value value;
-            value.SetString(StringRef(pattern.c_str(), pattern.size()));
-            return value;
+            _writer.string(regex.pattern());
         }
 
         result_type operator()(values::type const& type) const
         {
-            json_value value;
-            value.SetString(boost::lexical_cast<string>(type).c_str(), _allocator);
-            return value;
+            _writer.string(boost::lexical_cast<string>(type));
         }
 
         result_type operator()(values::variable const& variable) const
         {
-            return boost::apply_visitor(*this, variable.value());
+            boost::apply_visitor(*this, variable.value());
         }
 
         result_type operator()(values::array const& array) const
         {
-            json_value value;
-            value.SetArray();
-            value.Reserve(array.size(), _allocator);
-
+            _writer.start_array();
             for (auto const& element : array) {
-                value.PushBack(boost::apply_visitor(*this, *element), _allocator);
+                boost::apply_visitor(*this, element);
             }
-            return value;
+            _writer.end_array();
         }
 
         result_type operator()(values::hash const& hash) const
         {
-            json_value value;
-            value.SetObject();
-
+            _writer.start_object();
             for (auto const& kvp : hash) {
-                value.AddMember(
-                    json_value(boost::lexical_cast<string>(kvp.key()).c_str(), _allocator),
-                    boost::apply_visitor(*this, kvp.value()),
-                    _allocator);
+                auto const* key = kvp.key().as<string>();
+                _writer.key(key ? *key : boost::lexical_cast<string>(kvp.key()));
+                boost::apply_visitor(*this, kvp.value());
             }
-            return value;
+            _writer.end_object();
         }
 
      private:
-        json_allocator& _allocator;
+        data_writer& _writer;
     };
 
-    json_value value::to_json(json_allocator& allocator) const
+    void value::write(data_writer& writer) const
     {
-        return boost::apply_visitor(json_visitor(allocator), *this);
+        boost::apply_visitor(write_visitor(writer), *this);
     }
 
     void enumerate_string(string const& str, function<bool(string)> const& callback)
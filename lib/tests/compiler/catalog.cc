@@ -0,0 +1,296 @@
+#include <catch.hpp>
+#include <puppet/compiler/catalog.hpp>
+#include <puppet/compiler/catalog_summary.hpp>
+#include <puppet/compiler/attribute.hpp>
+#include <puppet/compiler/ast/ast.hpp>
+#include <rapidjson/document.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+using namespace std;
+using namespace puppet;
+using namespace puppet::runtime;
+using namespace puppet::compiler;
+namespace fs = boost::filesystem;
+
+static void add_file(catalog& catalog, string const& path, string const& content)
+{
+    auto resource = catalog.add(types::resource("File", path));
+    REQUIRE(resource);
+    static auto tree = ast::syntax_tree::create("site.pp");
+    ast::context context{ tree.get(), lexer::position(1, 1) };
+    resource->set(make_shared<attribute>("content", context, make_shared<values::value>(content), context));
+}
+
+static catalog make_catalog(string const& content)
+{
+    catalog catalog{ "node", "production" };
+    add_file(catalog, "/etc/motd", "hello");
+    add_file(catalog, "/etc/issue", content);
+    return catalog;
+}
+
+// Simulates one compilation in diff mode: the full catalog replaces the previous one and the changes are returned
+static string compile(catalog const& catalog, string const& path)
+{
+    catalog_summary previous;
+    previous.load(path);
+
+    ostringstream changes;
+    catalog.write(changes, catalog_format::json, false, &previous);
+
+    ofstream output(path);
+    catalog.write(output, catalog_format::json, false);
+    return changes.str();
+}
+
+static rapidjson::Document parse(string const& json)
+{
+    rapidjson::Document document;
+    document.Parse(json.c_str());
+    REQUIRE_FALSE(document.HasParseError());
+    REQUIRE(document.IsObject());
+    return document;
+}
+
+SCENARIO("catalog content hash", "[catalog]")
+{
+    auto first = make_catalog("first");
+    auto second = make_catalog("first");
+    REQUIRE(first.hash() == second.hash());
+
+    WHEN("an attribute differs") {
+        auto other = make_catalog("second");
+        REQUIRE(first.hash() != other.hash());
+    }
+    WHEN("a tag differs") {
+        second.find(types::resource("File", "/etc/motd"))->tag("motd");
+        REQUIRE(first.hash() != second.hash());
+
+        AND_WHEN("the same tag is added to the other catalog") {
+            first.find(types::resource("File", "/etc/motd"))->tag("MOTD");
+            REQUIRE(first.hash() == second.hash());
+        }
+    }
+}
+
+SCENARIO("writing catalog changes", "[catalog]")
+{
+    auto path = (fs::temp_directory_path() / fs::unique_path("catalog-%%%%-%%%%.json")).string();
+
+    GIVEN("no previous catalog") {
+        auto document = parse(compile(make_catalog("first"), path));
+        THEN("every resource is added") {
+            REQUIRE(document["previous_hash"].IsNull());
+            REQUIRE_FALSE(document["unchanged"].GetBool());
+            REQUIRE(document["resources"]["added"].Size() == 2);
+            REQUIRE(document["resources"]["changed"].Size() == 0);
+            REQUIRE(document["resources"]["removed"].Size() == 0);
+        }
+    }
+    GIVEN("a catalog compiled twice in a row") {
+        auto first = make_catalog("first");
+        compile(first, path);
+        auto document = parse(compile(make_catalog("first"), path));
+        THEN("the catalog is unchanged") {
+            REQUIRE(document["previous_hash"].GetString() == first.hash().to_string());
+            REQUIRE(document["unchanged"].GetBool());
+            REQUIRE(document["resources"]["added"].Size() == 0);
+            REQUIRE(document["resources"]["changed"].Size() == 0);
+            REQUIRE(document["resources"]["removed"].Size() == 0);
+        }
+        AND_WHEN("the catalog changes on the third compilation") {
+            catalog third{ "node", "production" };
+            add_file(third, "/etc/issue", "second");
+            add_file(third, "/etc/hosts", "localhost");
+            document = parse(compile(third, path));
+            THEN("only the changes are written") {
+                REQUIRE_FALSE(document["unchanged"].GetBool());
+                REQUIRE(document["resources"]["added"].Size() == 1);
+                REQUIRE(document["resources"]["added"][0]["title"].GetString() == string("/etc/hosts"));
+                REQUIRE(document["resources"]["changed"].Size() == 1);
+                REQUIRE(document["resources"]["changed"][0]["title"].GetString() == string("/etc/issue"));
+                REQUIRE(document["resources"]["removed"].Size() == 1);
+                REQUIRE(document["resources"]["removed"][0].GetString() == string("File[/etc/motd]"));
+            }
+        }
+    }
+
+    fs::remove(path);
+}
+
+SCENARIO("detecting dependency cycles", "[catalog]")
+{
+    catalog catalog{ "node", "production" };
+    auto a = catalog.add(types::resource("File", "/a"));
+    auto b = catalog.add(types::resource("File", "/b"));
+    auto c = catalog.add(types::resource("File", "/c"));
+    REQUIRE(a);
+    REQUIRE(b);
+    REQUIRE(c);
+
+    WHEN("the graph is acyclic") {
+        catalog.relate(relationship::require, *a, *b);
+        catalog.relate(relationship::require, *b, *c);
+        catalog.relate(relationship::require, *a, *c);
+        THEN("no cycle is detected") {
+            REQUIRE_NOTHROW(catalog.detect_cycles());
+        }
+    }
+    WHEN("two resources depend on each other") {
+        catalog.relate(relationship::require, *a, *b);
+        catalog.relate(relationship::before, *a, *b);
+        THEN("the cycle is reported starting at the first resource") {
+            try {
+                catalog.detect_cycles();
+                FAIL("expected a resource cycle exception");
+            } catch (resource_cycle_exception const& ex) {
+                REQUIRE(string(ex.what()) ==
+                    "found 1 resource dependency cycle:\n"
+                    "  1. File[/a] declared at <main>:0 => File[/b] declared at <main>:0 => File[/a]");
+            }
+        }
+    }
+    WHEN("a resource depends on itself") {
+        catalog.relate(relationship::require, *b, *b);
+        THEN("the self-loop is reported") {
+            try {
+                catalog.detect_cycles();
+                FAIL("expected a resource cycle exception");
+            } catch (resource_cycle_exception const& ex) {
+                REQUIRE(string(ex.what()) ==
+                    "found 1 resource dependency cycle:\n"
+                    "  1. File[/b] declared at <main>:0 => File[/b]");
+            }
+        }
+    }
+    WHEN("there are several cycles") {
+        auto d = catalog.add(types::resource("File", "/d"));
+        REQUIRE(d);
+        catalog.relate(relationship::require, *a, *b);
+        catalog.relate(relationship::require, *b, *c);
+        catalog.relate(relationship::require, *c, *a);
+        catalog.relate(relationship::notify, *d, *d);
+        THEN("one cycle is reported for each cyclic component") {
+            try {
+                catalog.detect_cycles();
+                FAIL("expected a resource cycle exception");
+            } catch (resource_cycle_exception const& ex) {
+                REQUIRE(string(ex.what()) ==
+                    "found 2 resource dependency cycles:\n"
+                    "  1. File[/a] declared at <main>:0 => File[/b] declared at <main>:0 => File[/c] declared at <main>:0 => File[/a]\n"
+                    "  2. File[/d] declared at <main>:0 => File[/d]");
+            }
+        }
+    }
+}
+
+static vector<pair<relationship, string>> edges(catalog const& catalog, resource const& resource)
+{
+    vector<pair<relationship, string>> result;
+    catalog.each_edge(resource, [&](relationship relation, compiler::resource const& target) {
+        result.emplace_back(relation, target.type().title());
+        return true;
+    });
+    return result;
+}
+
+SCENARIO("relating resources more than once", "[catalog]")
+{
+    catalog catalog{ "node", "production" };
+    auto a = catalog.add(types::resource("File", "/a"));
+    auto b = catalog.add(types::resource("File", "/b"));
+    REQUIRE(a);
+    REQUIRE(b);
+
+    catalog.relate(relationship::require, *a, *b);
+    auto hash = catalog.hash();
+
+    WHEN("the same relationship is added again") {
+        catalog.relate(relationship::require, *a, *b);
+        THEN("only one edge is in the graph and the hash is unchanged") {
+            REQUIRE(edges(catalog, *a).size() == 1);
+            REQUIRE(catalog.hash() == hash);
+        }
+    }
+    WHEN("a different relationship is added between the same resources") {
+        catalog.relate(relationship::subscribe, *a, *b);
+        THEN("both edges are in the graph") {
+            REQUIRE(edges(catalog, *a) == (vector<pair<relationship, string>>{
+                { relationship::require, "/b" },
+                { relationship::subscribe, "/b" }
+            }));
+            REQUIRE(catalog.hash() != hash);
+        }
+    }
+    WHEN("the reverse relationship is added") {
+        catalog.relate(relationship::before, *b, *a);
+        THEN("it is kept as a separate edge") {
+            REQUIRE(edges(catalog, *a).size() == 2);
+            REQUIRE(edges(catalog, *b).empty());
+        }
+    }
+}
+
+static void set_attribute(resource& resource, string const& name, values::value value)
+{
+    static auto tree = ast::syntax_tree::create("site.pp");
+    ast::context context{ tree.get(), lexer::position(1, 1) };
+    resource.set(make_shared<attribute>(name, context, make_shared<values::value>(rvalue_cast(value)), context));
+}
+
+static set<string> matching(catalog& catalog, string const& type, string const& attribute, string const& value)
+{
+    set<string> titles;
+    catalog.each_matching([&](resource& resource) {
+        titles.insert(resource.type().title());
+        return true;
+    }, type, attribute, value);
+    return titles;
+}
+
+SCENARIO("finding resources by attribute", "[catalog]")
+{
+    catalog catalog{ "node", "production" };
+    auto first = catalog.add(types::resource("Package", "first"));
+    auto second = catalog.add(types::resource("Package", "second"));
+    auto file = catalog.add(types::resource("File", "/etc/motd"));
+    REQUIRE(first);
+    REQUIRE(second);
+    REQUIRE(file);
+
+    set_attribute(*first, "alias", values::value(string("Foo")));
+    values::array aliases;
+    aliases.emplace_back(string("bar"));
+    aliases.emplace_back(string("FOO"));
+    set_attribute(*second, "alias", values::value(rvalue_cast(aliases)));
+    set_attribute(*file, "alias", values::value(string("foo")));
+
+    THEN("strings and array elements are matched case-insensitively") {
+        REQUIRE(matching(catalog, "Package", "alias", "foo") == (set<string>{ "first", "second" }));
+        REQUIRE(matching(catalog, "Package", "alias", "BAR") == (set<string>{ "second" }));
+        REQUIRE(matching(catalog, "Package", "alias", "baz").empty());
+    }
+    THEN("resources of other types are not matched") {
+        REQUIRE(matching(catalog, "File", "alias", "foo") == (set<string>{ "/etc/motd" }));
+        REQUIRE(matching(catalog, "Service", "alias", "foo").empty());
+    }
+    WHEN("an attribute is set after the index is built") {
+        REQUIRE(matching(catalog, "Package", "alias", "baz").empty());
+        set_attribute(*first, "alias", values::value(string("Baz")));
+        THEN("the resource is found by the new value") {
+            REQUIRE(matching(catalog, "Package", "alias", "baz") == (set<string>{ "first" }));
+        }
+    }
+    WHEN("a resource is added after the index is built") {
+        REQUIRE(matching(catalog, "Package", "alias", "foo") == (set<string>{ "first", "second" }));
+        auto third = catalog.add(types::resource("Package", "third"));
+        REQUIRE(third);
+        set_attribute(*third, "alias", values::value(string("foo")));
+        THEN("the new resource is found") {
+            REQUIRE(matching(catalog, "Package", "alias", "foo") == (set<string>{ "first", "second", "third" }));
+        }
+    }
+}
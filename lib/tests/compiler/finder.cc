@@ -0,0 +1,66 @@
+#include <catch.hpp>
+#include <puppet/compiler/finder.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <set>
+
+using namespace std;
+using namespace puppet;
+using namespace puppet::compiler;
+namespace fs = boost::filesystem;
+
+static void create_file(fs::path const& path)
+{
+    fs::create_directories(path.parent_path());
+    ofstream file{ path.string() };
+    REQUIRE(file);
+}
+
+static set<string> indexed_names(finder const& finder)
+{
+    set<string> names;
+    finder.each(find_type::manifest, [&](string const& name, string const&) {
+        names.insert(name);
+        return true;
+    });
+    return names;
+}
+
+SCENARIO("indexing manifests", "[finder]")
+{
+    auto directory = fs::temp_directory_path() / fs::unique_path("finder-%%%%-%%%%");
+    auto manifests = directory / "manifests";
+    create_file(manifests / "init.pp");
+    create_file(manifests / "foo" / "bar.pp");
+
+    finder finder{ directory.string() };
+
+    GIVEN("a symlinked directory") {
+        auto linked = fs::temp_directory_path() / fs::unique_path("finder-%%%%-%%%%");
+        create_file(linked / "baz.pp");
+        fs::create_directory_symlink(linked, manifests / "linked");
+        finder.index();
+        THEN("the manifests in the linked directory are indexed") {
+            REQUIRE(indexed_names(finder) == (set<string>{ "init", "foo::bar", "linked::baz" }));
+            REQUIRE(finder.find(find_type::manifest, "linked::baz") == (manifests / "linked" / "baz.pp").string());
+        }
+        fs::remove_all(linked);
+    }
+    GIVEN("a symlink to its own directory") {
+        fs::create_directory_symlink(manifests / "foo", manifests / "foo" / "self");
+        finder.index();
+        THEN("the symlink is not followed") {
+            REQUIRE(indexed_names(finder) == (set<string>{ "init", "foo::bar" }));
+        }
+    }
+    GIVEN("a symlink to an ancestor directory") {
+        fs::create_directory_symlink(manifests, manifests / "foo" / "parent");
+        finder.index();
+        THEN("the symlink is not followed") {
+            REQUIRE(indexed_names(finder) == (set<string>{ "init", "foo::bar" }));
+            REQUIRE(finder.find(find_type::manifest, "foo::parent::init").empty());
+        }
+    }
+
+    fs::remove_all(directory);
+}
@@ -0,0 +1,118 @@
+#include <catch.hpp>
+#include <puppet/compiler/registry.hpp>
+#include <puppet/compiler/environment.hpp>
+#include <puppet/compiler/settings.hpp>
+#include <puppet/compiler/parser/parser.hpp>
+#include <puppet/compiler/exceptions.hpp>
+#include <puppet/logging/logger.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+using namespace std;
+using namespace puppet;
+using namespace puppet::compiler;
+namespace fs = boost::filesystem;
+
+static void write_file(fs::path const& path, string const& contents)
+{
+    fs::create_directories(path.parent_path());
+    ofstream file{ path.string() };
+    REQUIRE(file);
+    file << contents;
+}
+
+SCENARIO("unregistering definitions", "[registry]")
+{
+    registry registry;
+    auto first = parser::parse_string("class foo { } class foo::bar { } define baz() { }", "first.pp");
+    auto second = parser::parse_string("class qux { }", "second.pp");
+    registry.import(*first);
+    registry.import(*second);
+
+    REQUIRE(registry.find_class("foo"));
+    REQUIRE(registry.find_class("foo::bar"));
+    REQUIRE(registry.find_defined_type("baz"));
+    REQUIRE(registry.find_class("qux"));
+
+    auto definitions = registry.find_class("foo");
+    registry.unregister(*first);
+
+    THEN("only the definitions from the unregistered tree are removed") {
+        REQUIRE_FALSE(registry.find_class("foo"));
+        REQUIRE_FALSE(registry.find_class("foo::bar"));
+        REQUIRE_FALSE(registry.find_defined_type("baz"));
+        REQUIRE(registry.find_class("qux"));
+    }
+    THEN("class definitions already found remain valid") {
+        REQUIRE(definitions);
+        REQUIRE(definitions->size() == 1);
+        REQUIRE(definitions->front().name() == "foo");
+    }
+    THEN("the definitions can be registered again from a new tree") {
+        auto changed = parser::parse_string("class foo { } define baz($x) { }", "first.pp");
+        registry.import(*changed);
+        REQUIRE(registry.find_class("foo"));
+        REQUIRE(registry.find_defined_type("baz"));
+        REQUIRE_FALSE(registry.find_class("foo::bar"));
+    }
+    THEN("unregistering a tree that is not imported does nothing") {
+        registry.unregister(*first);
+        REQUIRE(registry.find_class("qux"));
+    }
+}
+
+SCENARIO("refreshing an environment", "[environment]")
+{
+    auto directory = fs::temp_directory_path() / fs::unique_path("environment-%%%%-%%%%");
+    auto init = directory / "modules" / "mod" / "manifests" / "init.pp";
+    auto other = directory / "modules" / "mod" / "manifests" / "other.pp";
+    write_file(init, "class mod { }\n");
+    write_file(other, "class mod::other { }\n");
+
+    logging::console_logger logger;
+    compiler::settings settings;
+    compiler::environment environment{ logger, settings, "test", directory.string() };
+    environment.import(logger, find_type::manifest, "mod");
+    REQUIRE(environment.registry().find_class("mod"));
+    REQUIRE_FALSE(environment.registry().find_class("mod::other"));
+
+    WHEN("nothing has changed") {
+        THEN("nothing is refreshed") {
+            REQUIRE(environment.refresh(logger) == 0);
+            REQUIRE(environment.registry().find_class("mod"));
+        }
+    }
+    WHEN("an imported file changes") {
+        write_file(init, "class mod { }\nclass mod::extra { }\n");
+        THEN("the file is imported again") {
+            REQUIRE(environment.refresh(logger) == 1);
+            REQUIRE(environment.registry().find_class("mod"));
+            REQUIRE(environment.registry().find_class("mod::extra"));
+        }
+    }
+    WHEN("an imported file is removed") {
+        fs::remove(init);
+        THEN("its definitions are unregistered") {
+            REQUIRE(environment.refresh(logger) == 1);
+            REQUIRE_FALSE(environment.registry().find_class("mod"));
+        }
+    }
+    WHEN("a file is added to a module") {
+        write_file(directory / "modules" / "mod" / "manifests" / "added.pp", "class mod::added { }\n");
+        THEN("the module index picks it up") {
+            REQUIRE(environment.refresh(logger) == 0);
+            environment.import(logger, find_type::manifest, "mod::added");
+            REQUIRE(environment.registry().find_class("mod::added"));
+        }
+    }
+    WHEN("a changed file no longer parses") {
+        write_file(init, "class mod {\n");
+        THEN("the definitions are unregistered and the error is reported on the next import") {
+            REQUIRE(environment.refresh(logger) == 1);
+            REQUIRE_FALSE(environment.registry().find_class("mod"));
+            REQUIRE_THROWS_AS(environment.import(logger, find_type::manifest, "mod"), compilation_exception const&);
+        }
+    }
+
+    fs::remove_all(directory);
+}
@@ -0,0 +1,81 @@
+#include <catch.hpp>
+#include <puppet/compiler/scheduler.hpp>
+#include <atomic>
+#include <stdexcept>
+
+using namespace std;
+using namespace puppet;
+using namespace puppet::compiler;
+
+SCENARIO("scheduling tasks", "[scheduler]")
+{
+    compiler::scheduler scheduler{ 4 };
+    REQUIRE(scheduler.threads() == 4);
+
+    atomic<size_t> count{ 0 };
+
+    WHEN("waiting for queued tasks") {
+        for (size_t i = 0; i < 1000; ++i) {
+            scheduler.queue([&]() { ++count; });
+        }
+        scheduler.wait();
+        THEN("every task has run") {
+            REQUIRE(count == 1000u);
+        }
+    }
+    WHEN("tasks queue more tasks") {
+        for (size_t i = 0; i < 10; ++i) {
+            scheduler.queue([&]() {
+                for (size_t j = 0; j < 10; ++j) {
+                    scheduler.queue([&]() { ++count; });
+                }
+            });
+        }
+        scheduler.wait();
+        THEN("the wait includes the tasks queued by tasks") {
+            REQUIRE(count == 100u);
+        }
+    }
+    WHEN("tasks throw exceptions") {
+        for (size_t i = 0; i < 100; ++i) {
+            scheduler.queue([&, i]() {
+                ++count;
+                if (i % 10 == 0) {
+                    throw runtime_error("task failed");
+                }
+            });
+        }
+        THEN("waiting rethrows an exception after every task has run") {
+            REQUIRE_THROWS_AS(scheduler.wait(), runtime_error const&);
+            REQUIRE(count == 100u);
+        }
+        AND_THEN("the exception is only rethrown once and the scheduler can still be used") {
+            REQUIRE_THROWS_AS(scheduler.wait(), runtime_error const&);
+            scheduler.wait();
+            scheduler.queue([&]() { ++count; });
+            scheduler.wait();
+            REQUIRE(count == 101u);
+        }
+    }
+    WHEN("waiting without any tasks") {
+        scheduler.wait();
+        REQUIRE(count == 0u);
+    }
+    WHEN("queuing an empty task") {
+        scheduler.queue(nullptr);
+        scheduler.wait();
+        REQUIRE(count == 0u);
+    }
+}
+
+SCENARIO("destroying a scheduler", "[scheduler]")
+{
+    atomic<size_t> count{ 0 };
+    {
+        compiler::scheduler scheduler{ 2 };
+        for (size_t i = 0; i < 100; ++i) {
+            scheduler.queue([&]() { ++count; });
+        }
+    }
+    REQUIRE(count == 100u);
+}
@@ -0,0 +1,10 @@
+$words = split('alpha beta gamma delta epsilon zeta eta theta iota kappa lambda mu nu xi omicron pi rho sigma tau upsilon phi chi psi omega', ' ')
+
+$names = $words.map |$index, $word| { "${word}-${index}" }
+
+$lookup = $names.reduce({}) |$memo, $name| { $memo + { $name => "${name} on ${facts['hostname']}" } }
+
+class { 'benchmark':
+  names  => $names + $words,
+  lookup => $lookup,
+}
@@ -0,0 +1,14 @@
+define benchmark::entry($value, $position) {
+  $settings = {
+    'ensure'  => 'file',
+    'content' => "${position}: ${value}",
+    'mode'    => '0644',
+  }
+
+  file { "/tmp/benchmark/${title}":
+    ensure  => $settings['ensure'],
+    content => $settings['content'],
+    mode    => $settings['mode'],
+    tag     => [$title, 'benchmark'],
+  }
+}
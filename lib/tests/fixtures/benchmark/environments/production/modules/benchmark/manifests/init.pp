@@ -0,0 +1,16 @@
+class benchmark($names, $lookup) {
+  $names.each |$index, $name| {
+    if $name in $lookup {
+      benchmark::entry { $name:
+        value    => $lookup[$name],
+        position => $index,
+      }
+    }
+  }
+
+  $filtered = $names.filter |$name| { $name =~ /^[a-m]/ }
+
+  notify { 'filtered':
+    message => "${filtered}",
+  }
+}
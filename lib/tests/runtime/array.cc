@@ -0,0 +1,59 @@
+#include <catch.hpp>
+#include <puppet/runtime/values/value.hpp>
+
+using namespace std;
+using namespace puppet;
+using namespace puppet::runtime;
+namespace values = puppet::runtime::values;
+
+static values::array make_array(initializer_list<int64_t> elements)
+{
+    values::array array;
+    for (auto element : elements) {
+        array.emplace_back(element);
+    }
+    return array;
+}
+
+SCENARIO("modifying shared arrays", "[array]")
+{
+    auto original = make_array({ 1, 2, 3 });
+    values::array copy = original;
+
+    WHEN("inserting at a const iterator of shared elements") {
+        auto it = copy.insert(copy.cbegin() + 1, values::value(static_cast<int64_t>(5)));
+        THEN("the element is inserted into the copy only") {
+            REQUIRE(*it == values::value(static_cast<int64_t>(5)));
+            REQUIRE(copy == make_array({ 1, 5, 2, 3 }));
+            REQUIRE(original == make_array({ 1, 2, 3 }));
+        }
+    }
+    WHEN("inserting a range at the end of shared elements") {
+        auto other = make_array({ 4, 5 });
+        copy.insert(copy.cend(), other.cbegin(), other.cend());
+        THEN("the range is appended to the copy only") {
+            REQUIRE(copy == make_array({ 1, 2, 3, 4, 5 }));
+            REQUIRE(original == make_array({ 1, 2, 3 }));
+        }
+    }
+    WHEN("erasing a range of shared elements") {
+        auto it = copy.erase(copy.cbegin(), copy.cbegin() + 2);
+        THEN("the elements are erased from the copy only") {
+            REQUIRE(*it == values::value(static_cast<int64_t>(3)));
+            REQUIRE(copy == make_array({ 3 }));
+            REQUIRE(original == make_array({ 1, 2, 3 }));
+        }
+    }
+    WHEN("erasing an element of shared elements") {
+        copy.erase(copy.cend() - 1);
+        THEN("the element is erased from the copy only") {
+            REQUIRE(copy == make_array({ 1, 2 }));
+            REQUIRE(original == make_array({ 1, 2, 3 }));
+        }
+    }
+    WHEN("inserting into an empty array") {
+        values::array empty;
+        empty.insert(empty.cbegin(), values::value(static_cast<int64_t>(1)));
+        REQUIRE(empty == make_array({ 1 }));
+    }
+}
@@ -0,0 +1,145 @@
+#include <catch.hpp>
+#include <puppet/runtime/cbor_reader.hpp>
+#include <puppet/runtime/cbor_writer.hpp>
+#include <puppet/runtime/json_writer.hpp>
+#include <puppet/runtime/values/value.hpp>
+#include <puppet/compiler/catalog.hpp>
+#include <puppet/compiler/attribute.hpp>
+#include <puppet/compiler/ast/ast.hpp>
+#include <puppet/cast.hpp>
+#include <rapidjson/document.h>
+#include <functional>
+#include <limits>
+#include <sstream>
+
+using namespace std;
+using namespace puppet;
+using namespace puppet::runtime;
+namespace values = puppet::runtime::values;
+
+// Writes the data as JSON directly and as JSON replayed from CBOR
+static pair<string, string> round_trip(function<void(data_writer&)> const& write)
+{
+    ostringstream direct;
+    {
+        json_writer writer{ direct, false };
+        write(writer);
+    }
+
+    ostringstream cbor;
+    {
+        cbor_writer writer{ cbor };
+        write(writer);
+    }
+
+    ostringstream replayed;
+    {
+        json_writer writer{ replayed, false };
+        auto data = cbor.str();
+        REQUIRE(read_cbor(data.data(), data.size(), writer));
+    }
+    return make_pair(direct.str(), replayed.str());
+}
+
+static void require_round_trip(function<void(data_writer&)> const& write)
+{
+    auto result = round_trip(write);
+    REQUIRE(result.second == result.first);
+}
+
+SCENARIO("replaying CBOR as JSON", "[cbor]")
+{
+    WHEN("writing integers") {
+        for (int64_t value : {
+            numeric_limits<int64_t>::min(),
+            static_cast<int64_t>(-4294967297),
+            static_cast<int64_t>(-65537),
+            static_cast<int64_t>(-257),
+            static_cast<int64_t>(-25),
+            static_cast<int64_t>(-24),
+            static_cast<int64_t>(-1),
+            static_cast<int64_t>(0),
+            static_cast<int64_t>(23),
+            static_cast<int64_t>(24),
+            static_cast<int64_t>(255),
+            static_cast<int64_t>(256),
+            static_cast<int64_t>(65535),
+            static_cast<int64_t>(65536),
+            static_cast<int64_t>(4294967296),
+            numeric_limits<int64_t>::max() }) {
+            CAPTURE(value);
+            require_round_trip([&](data_writer& writer) { writer.number(value); });
+        }
+    }
+    WHEN("writing doubles") {
+        for (double value : { 0.0, -0.5, 3.14159, 1e300, -2.5e-300, numeric_limits<double>::max(), numeric_limits<double>::min() }) {
+            CAPTURE(value);
+            require_round_trip([&](data_writer& writer) { writer.number(value); });
+        }
+    }
+    WHEN("writing strings and keys at length boundaries") {
+        for (size_t size : { 0, 1, 23, 24, 255, 256, 65535, 65536 }) {
+            CAPTURE(size);
+            string value(size, 'x');
+            require_round_trip([&](data_writer& writer) {
+                writer.start_object();
+                writer.key(value);
+                writer.string(value);
+                writer.end_object();
+            });
+        }
+    }
+    WHEN("writing nested empty arrays and objects") {
+        require_round_trip([](data_writer& writer) {
+            writer.start_array();
+            writer.start_array();
+            writer.end_array();
+            writer.start_object();
+            writer.end_object();
+            writer.start_array();
+            writer.start_object();
+            writer.key("empty");
+            writer.start_array();
+            writer.end_array();
+            writer.end_object();
+            writer.end_array();
+            writer.null();
+            writer.boolean(true);
+            writer.boolean(false);
+            writer.end_array();
+        });
+    }
+    WHEN("writing values") {
+        values::hash hash;
+        hash.set(values::value(string("integer")), values::value(numeric_limits<int64_t>::min()));
+        hash.set(values::value(string("float")), values::value(static_cast<long double>(-1.5)));
+        hash.set(values::value(string("string")), values::value(string(300, 'y')));
+        hash.set(values::value(string("array")), values::value(values::array{ values::value(values::array{}), values::value(values::hash{}) }));
+        values::value value{ rvalue_cast(hash) };
+        require_round_trip([&](data_writer& writer) { value.write(writer); });
+    }
+    WHEN("writing a catalog") {
+        compiler::catalog catalog{ "node", "production" };
+        auto tree = compiler::ast::syntax_tree::create("site.pp");
+        compiler::ast::context context{ tree.get(), compiler::lexer::position(1, 1) };
+        for (auto const& title : { "/etc/motd", "/etc/issue" }) {
+            auto resource = catalog.add(types::resource("File", title));
+            REQUIRE(resource);
+            resource->set(make_shared<compiler::attribute>("content", context, make_shared<values::value>(string(70000, 'z')), context));
+            resource->set(make_shared<compiler::attribute>("mode", context, make_shared<values::value>(static_cast<int64_t>(-420)), context));
+            resource->tag("config");
+        }
+        auto result = round_trip([&](data_writer& writer) { catalog.write(writer); });
+
+        // The catalog's version is the time it was written, so compare the documents without it
+        rapidjson::Document direct;
+        direct.Parse(result.first.c_str());
+        rapidjson::Document replayed;
+        replayed.Parse(result.second.c_str());
+        REQUIRE_FALSE(direct.HasParseError());
+        REQUIRE_FALSE(replayed.HasParseError());
+        REQUIRE(direct.RemoveMember("version"));
+        REQUIRE(replayed.RemoveMember("version"));
+        REQUIRE(direct == replayed);
+    }
+}
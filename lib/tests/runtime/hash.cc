@@ -0,0 +1,154 @@
+#include <catch.hpp>
+#include <puppet/runtime/values/value.hpp>
+#include <vector>
+
+using namespace std;
+using namespace puppet;
+using namespace puppet::runtime;
+namespace values = puppet::runtime::values;
+
+static values::value make_value(int64_t value)
+{
+    return values::value(value);
+}
+
+static vector<string> keys(values::hash const& hash)
+{
+    vector<string> result;
+    for (auto const& kvp : hash) {
+        result.push_back(*kvp.key().as<string>());
+    }
+    return result;
+}
+
+SCENARIO("using a hash", "[hash]")
+{
+    values::hash hash;
+    REQUIRE(hash.empty());
+    REQUIRE_FALSE(hash.get(string("missing")));
+
+    for (auto const& key : { "c", "a", "d", "b" }) {
+        hash.set(values::value(string(key)), make_value(static_cast<int64_t>(hash.size())));
+    }
+    REQUIRE(hash.size() == 4);
+
+    WHEN("enumerating the hash") {
+        THEN("pairs are in insertion order") {
+            REQUIRE(keys(hash) == (vector<string>{ "c", "a", "d", "b" }));
+        }
+    }
+    WHEN("setting an existing key") {
+        hash.set(values::value(string("a")), make_value(100));
+        THEN("the value is replaced in place") {
+            REQUIRE(hash.size() == 4);
+            REQUIRE(keys(hash) == (vector<string>{ "c", "a", "d", "b" }));
+            REQUIRE(*hash.get(string("a")) == make_value(100));
+        }
+    }
+    WHEN("erasing a key") {
+        REQUIRE(hash.erase(values::value(string("a"))));
+        THEN("the remaining pairs keep their order and can still be found") {
+            REQUIRE(keys(hash) == (vector<string>{ "c", "d", "b" }));
+            REQUIRE_FALSE(hash.get(string("a")));
+            REQUIRE(*hash.get(string("c")) == make_value(0));
+            REQUIRE(*hash.get(string("d")) == make_value(2));
+            REQUIRE(*hash.get(string("b")) == make_value(3));
+        }
+        AND_WHEN("the key is set again") {
+            hash.set(values::value(string("a")), make_value(4));
+            THEN("it is added to the end") {
+                REQUIRE(keys(hash) == (vector<string>{ "c", "d", "b", "a" }));
+                REQUIRE(*hash.get(string("a")) == make_value(4));
+            }
+        }
+    }
+    WHEN("erasing a key that does not exist") {
+        REQUIRE_FALSE(hash.erase(values::value(string("missing"))));
+        REQUIRE(hash.size() == 4);
+    }
+    WHEN("looking up keys that are not strings") {
+        hash.set(make_value(1), values::value(string("one")));
+        hash.set(values::value(string("1")), values::value(string("string one")));
+        THEN("keys of different types are distinct") {
+            REQUIRE(hash.size() == 6);
+            REQUIRE(*hash.get(make_value(1)) == values::value(string("one")));
+            REQUIRE(*hash.get(string("1")) == values::value(string("string one")));
+        }
+    }
+}
+
+SCENARIO("growing and shrinking a hash", "[hash]")
+{
+    values::hash hash;
+    size_t const count = 5000;
+    for (size_t i = 0; i < count; ++i) {
+        hash.set(make_value(static_cast<int64_t>(i)), make_value(static_cast<int64_t>(i * 2)));
+    }
+    REQUIRE(hash.size() == count);
+
+    // Erase every third key
+    for (size_t i = 0; i < count; i += 3) {
+        REQUIRE(hash.erase(make_value(static_cast<int64_t>(i))));
+    }
+
+    size_t expected = 1;
+    for (auto const& kvp : hash) {
+        REQUIRE(kvp.key() == make_value(static_cast<int64_t>(expected)));
+        expected += (expected % 3 == 1) ? 1 : 2;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        auto value = hash.get(make_value(static_cast<int64_t>(i)));
+        if (i % 3 == 0) {
+            REQUIRE_FALSE(value);
+        } else {
+            REQUIRE(value);
+            REQUIRE(*value == make_value(static_cast<int64_t>(i * 2)));
+        }
+    }
+}
+
+SCENARIO("copying a hash", "[hash]")
+{
+    values::hash original;
+    original.set(values::value(string("a")), make_value(1));
+    original.set(values::value(string("b")), make_value(2));
+
+    values::hash copy = original;
+    values::hash const& shared = copy;
+    REQUIRE(&*shared.cbegin() == &*original.cbegin());
+
+    WHEN("looking up a missing key through a non-const hash") {
+        REQUIRE_FALSE(copy.get(string("missing")));
+        THEN("the pairs are still shared") {
+            REQUIRE(&*shared.cbegin() == &*original.cbegin());
+        }
+    }
+    WHEN("setting a key in the copy") {
+        copy.set(values::value(string("c")), make_value(3));
+        THEN("the original is unchanged") {
+            REQUIRE(original.size() == 2);
+            REQUIRE_FALSE(original.get(string("c")));
+            REQUIRE(copy.size() == 3);
+        }
+    }
+    WHEN("modifying a value through the copy") {
+        *copy.get(string("a")) = make_value(10);
+        THEN("the original is unchanged") {
+            REQUIRE(*original.get(string("a")) == make_value(1));
+            REQUIRE(*copy.get(string("a")) == make_value(10));
+        }
+    }
+    WHEN("erasing a key from the copy") {
+        REQUIRE(copy.erase(values::value(string("a"))));
+        THEN("the original is unchanged") {
+            REQUIRE(keys(original) == (vector<string>{ "a", "b" }));
+            REQUIRE(keys(copy) == (vector<string>{ "b" }));
+        }
+    }
+    WHEN("merging the shared pairs into the copy") {
+        copy.set(original.cbegin(), original.cend());
+        THEN("the pairs are unchanged") {
+            REQUIRE(copy == original);
+        }
+    }
+}
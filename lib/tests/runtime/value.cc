@@ -0,0 +1,57 @@
+#include <catch.hpp>
+#include <puppet/runtime/values/value.hpp>
+#include <puppet/compiler/settings.hpp>
+#include <puppet/compiler/environment.hpp>
+#include <puppet/compiler/node.hpp>
+#include <puppet/logging/logger.hpp>
+#include <chrono>
+
+using namespace std;
+using namespace puppet;
+using namespace puppet::runtime;
+namespace values = puppet::runtime::values;
+
+SCENARIO("value size", "[value]")
+{
+    // Every value pays for the largest alternative, so types and regexes are kept out of line
+    REQUIRE(sizeof(values::type) > sizeof(values::value));
+    REQUIRE(sizeof(values::regex) <= 2 * sizeof(void*));
+    REQUIRE(sizeof(values::value) <= 64);
+}
+
+// Hidden by default; run with: puppet_test "[benchmark]"
+SCENARIO("evaluation throughput", "[.][benchmark]")
+{
+    char const* argv[] = {
+        "puppetcpp",
+        "--code-dir", FIXTURES_DIR "benchmark",
+        "--facts", FIXTURES_DIR "benchmark/facts.yaml",
+        "--node", "benchmark.example.com"
+    };
+    compiler::settings settings{ static_cast<int>(sizeof(argv) / sizeof(argv[0])), argv };
+
+    logging::console_logger logger;
+    logger.level(logging::level::warning);
+
+    auto environment = make_shared<compiler::environment>(logger, settings, settings.environment(), settings.environment_directory());
+
+    // The first compilation parses the manifests; only evaluation is measured afterwards
+    size_t resources = 0;
+    {
+        compiler::node node{ logger, settings.node_name(), environment, settings.facts() };
+        resources = node.compile().size();
+    }
+    REQUIRE(logger.errors() == 0);
+    REQUIRE(resources > 0);
+
+    size_t const iterations = 200;
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        compiler::node node{ logger, settings.node_name(), environment, settings.facts() };
+        REQUIRE(node.compile().size() == resources);
+    }
+    auto elapsed = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+
+    WARN("sizeof(values::value): " << sizeof(values::value) << " bytes");
+    WARN("compiled " << iterations << " catalogs of " << resources << " resources in " << elapsed / 1000 << " ms (" << elapsed / iterations << " us per compilation)");
+}